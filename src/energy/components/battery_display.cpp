@@ -272,10 +272,6 @@ auto battery_display::can_get_from(const battery_display &battery) const -> bool
 	return battery_->get().can_get_from(battery.battery_->get());
 }
 
-auto battery_display::transfer_energy_from(const battery_display &other) const -> void {
-	battery_->get().transfer_energy_from(other.battery_->get());
-}
-
 auto battery_display::get_battery_base_color() const -> Color {
 	return energy_colors.at(battery_->get().at(0));
 }
@@ -57,7 +57,7 @@ public:
 	// =============================================================================
 	// Battery Management
 	// =============================================================================
-	auto set_battery(battery &bat) -> void {
+	auto set_battery(const battery &bat) -> void {
 		battery_ = bat;
 	}
 
@@ -95,7 +95,6 @@ public:
 	[[nodiscard]] auto is_battery_full() const -> bool;
 	[[nodiscard]] auto is_battery_empty() const -> bool;
 	[[nodiscard]] auto can_get_from(const battery_display &battery) const -> bool;
-	auto transfer_energy_from(const battery_display &other) const -> void;
 
 private:
 	// =============================================================================
@@ -139,7 +138,7 @@ private:
 	// =============================================================================
 	// Battery Data
 	// =============================================================================
-	std::optional<std::reference_wrapper<battery>> battery_;
+	std::optional<std::reference_wrapper<const battery>> battery_;
 	size_t index_{0};
 
 	// =============================================================================
@@ -5,11 +5,13 @@
 
 #include <pxe/result.hpp>
 
-#include <algorithm>
+#include "zobrist.hpp"
+
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <format>
 #include <string>
-#include <vector>
 
 namespace energy {
 
@@ -17,37 +19,33 @@ void battery::add(const int energy_type) {
 	assert(energy_type > 0 && energy_type <= max_energy_types && "Invalid energy type");
 	assert(current_state_ != state::closed && "Cannot add energy to a closed battery");
 	assert(current_state_ != state::full && "Cannot add energy to a full battery");
-	energies_.push_back(energy_type);
-	if(energies_.size() < max_energy) {
+	top_run_ = static_cast<std::uint8_t>(top_energy() == energy_type ? top_run_ + 1 : 1);
+	energies_.at(count_) = static_cast<std::uint8_t>(energy_type);
+	hash_ ^= zobrist::key(count_, energy_type);
+	++count_;
+	if(count_ < max_energy) {
 		current_state_ = state::normal;
 	} else {
-		const int first = energies_.front();
-		const bool all_same = std::ranges::all_of(energies_, [&](const int energy) -> bool { return energy == first; });
-		current_state_ = all_same ? state::closed : state::full;
+		current_state_ = top_run_ == max_energy ? state::closed : state::full;
 	}
 }
 
 void battery::remove() {
 	assert(current_state_ != state::empty && "Cannot remove energy from an empty battery");
 	assert(current_state_ != state::closed && "Cannot remove energy from a closed battery");
-	energies_.pop_back();
-	current_state_ = energies_.empty() ? state::empty : state::normal;
-}
-
-auto battery::top() const -> std::vector<int> {
-	if(energies_.empty()) {
-		return {};
+	--count_;
+	hash_ ^= zobrist::key(count_, energies_.at(count_));
+	energies_.at(count_) = 0;
+	current_state_ = count_ == 0 ? state::empty : state::normal;
+	// the run below the removed energy is only walked when the removed one was the last of its run
+	if(top_run_ > 1) {
+		--top_run_;
+		return;
 	}
-	const auto last = energies_.back();
-	std::vector result{last};
-	for(int i = static_cast<int>(energies_.size()) - 2; i >= 0; --i) {
-		if(energies_.at(i) == last) {
-			result.push_back(last);
-		} else {
-			break;
-		}
+	top_run_ = count_ == 0 ? 0 : 1;
+	while(top_run_ < count_ && energies_.at(count_ - top_run_ - 1) == energies_.at(count_ - 1)) {
+		++top_run_;
 	}
-	return result;
 }
 
 auto battery::can_get_from(const battery &other) const -> bool {
@@ -56,22 +54,21 @@ auto battery::can_get_from(const battery &other) const -> bool {
 		return false;
 	}
 	// If this battery is empty, it can always get energy
-	if(energies_.empty()) {
+	if(empty()) {
 		return true;
 	}
-	const auto other_top = other.top();
 	// Check if there is enough space with the other battery's top energies
-	if(size() + other_top.size() > max_energy) {
+	if(size() + other.top_run() > max_energy) {
 		return false;
 	}
 	// Check if the top energy types match
-	const auto current_top = top();
-	return other_top.front() == current_top.front();
+	return other.top_energy() == top_energy();
 }
 
 void battery::transfer_energy_from(battery &other) {
 	assert(can_get_from(other) && "Cannot transfer energy from the other battery");
-	for(const auto energy_type: other.top()) {
+	const auto energy_type = other.top_energy();
+	for(auto moved = other.top_run(); moved > 0; --moved) {
 		add(energy_type);
 		other.remove();
 	}
@@ -79,12 +76,20 @@ void battery::transfer_energy_from(battery &other) {
 
 auto battery::string() const -> std::string {
 	std::string result;
-	for(const auto energy: energies_) {
-		result += std::format("{:X}", energy);
+	for(size_t i = 0; i < count_; ++i) {
+		result += std::format("{:X}", energies_.at(i));
 	}
 	return std::format("{:0<{}}", result, max_energy);
 }
 
+auto battery::pack() const -> std::uint16_t {
+	std::uint16_t result = 0;
+	for(size_t i = 0; i < count_; ++i) {
+		result |= static_cast<std::uint16_t>(energies_.at(i) << (i * 4));
+	}
+	return result;
+}
+
 auto battery::from_string(const std::string &str) -> pxe::result<battery> {
 	battery new_battery;
 	auto total = 0;
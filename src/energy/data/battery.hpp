@@ -5,10 +5,10 @@
 
 #include <pxe/result.hpp>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <string>
-#include <vector>
 
 namespace energy {
 
@@ -27,32 +27,46 @@ public:
 		return current_state_ == state::empty;
 	}
 	[[nodiscard]] auto size() const -> int {
-		return static_cast<int>(energies_.size());
+		return count_;
 	}
 
 	void add(int energy_type);
 	void remove();
 
-	[[nodiscard]] auto top() const -> std::vector<int>;
+	// the energy on top and how many of that energy are stacked there, zero for an empty battery
+	[[nodiscard]] auto top_energy() const -> int {
+		return count_ == 0 ? 0 : energies_.at(count_ - 1);
+	}
+	[[nodiscard]] auto top_run() const -> int {
+		return top_run_;
+	}
 
 	[[nodiscard]] auto can_get_from(const battery &other) const -> bool;
 
 	auto transfer_energy_from(battery &other) -> void;
 
 	[[nodiscard]] auto at(const size_t index) const -> int {
-		if(index >= energies_.size()) {
+		if(index >= count_) {
 			return 0;
 		}
 		return energies_.at(index);
 	}
 
 	[[nodiscard]] auto string() const -> std::string;
+	[[nodiscard]] auto pack() const -> std::uint16_t;
+
+	[[nodiscard]] auto hash() const -> std::uint64_t {
+		return hash_;
+	}
 	[[nodiscard]] static auto from_string(const std::string &str) -> pxe::result<battery>;
 
 private:
 	enum class state : std::uint8_t { normal, empty, full, closed };
-	std::vector<int> energies_;
+	std::array<std::uint8_t, max_energy> energies_{};
+	std::uint8_t count_ = 0;
+	std::uint8_t top_run_ = 0;
 	state current_state_ = state::empty;
+	std::uint64_t hash_ = 0;
 };
 
 } // namespace energy
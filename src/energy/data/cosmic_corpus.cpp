@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "cosmic_corpus.hpp"
+
+#include <pxe/result.hpp>
+
+#include "mapped_file.hpp"
+#include "packed_puzzle.hpp"
+#include "puzzle.hpp"
+#include "rng.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace energy {
+
+namespace {
+
+template<typename T>
+auto fits(const std::size_t value) -> bool {
+	return value <= std::numeric_limits<T>::max();
+}
+
+} // namespace
+
+auto cosmic_corpus::open(const std::string &path) -> pxe::result<> {
+	close();
+	if(const auto err = file_.open(path).unwrap(); err) {
+		return pxe::error(std::format("failed to load cosmic corpus: {}", path), *err);
+	}
+	if(const auto err = validate().unwrap(); err) {
+		close();
+		return pxe::error(std::format("invalid cosmic corpus: {}", path), *err);
+	}
+	return true;
+}
+
+auto cosmic_corpus::close() -> void {
+	file_.close();
+}
+
+auto cosmic_corpus::validate() const -> pxe::result<> {
+	if(file_.bytes().size() < sizeof(file_header)) {
+		return pxe::error("cosmic corpus is too small for its header");
+	}
+	const auto header = this->header();
+	if(header.magic != magic || header.version != version) {
+		return pxe::error("cosmic corpus has an unknown format");
+	}
+	const auto expected = sizeof(file_header) + (std::size_t{header.shapes} * sizeof(file_shape))
+						  + (std::size_t{header.records} * sizeof(file_record));
+	if(file_.bytes().size() < expected) {
+		return pxe::error("cosmic corpus is truncated");
+	}
+	for(std::size_t i = 0; i < header.shapes; ++i) {
+		if(const auto shape = shape_at(i); std::size_t{shape.first} + shape.count > header.records) {
+			return pxe::error("cosmic corpus shape points past its records");
+		}
+	}
+	return true;
+}
+
+auto cosmic_corpus::find_shape(const std::size_t energies, const std::size_t empty) const
+	-> std::optional<file_shape> {
+	if(file_.bytes().empty()) {
+		return std::nullopt;
+	}
+	const auto shapes = header().shapes;
+	for(std::size_t i = 0; i < shapes; ++i) {
+		if(const auto shape = shape_at(i); shape.energies == energies && shape.empty == empty) {
+			return shape;
+		}
+	}
+	return std::nullopt;
+}
+
+auto cosmic_corpus::header() const -> file_header {
+	return file_.read<file_header>(0);
+}
+
+auto cosmic_corpus::shape_at(const std::size_t index) const -> file_shape {
+	return file_.read<file_shape>(sizeof(file_header) + (index * sizeof(file_shape)));
+}
+
+auto cosmic_corpus::record(const std::size_t index) const -> file_record {
+	const auto offset = sizeof(file_header) + (std::size_t{header().shapes} * sizeof(file_shape))
+						+ (index * sizeof(file_record));
+	return file_.read<file_record>(offset);
+}
+
+auto cosmic_corpus::decode(const file_record &value) -> level {
+	packed_puzzle packed;
+	for(std::size_t i = 0; i < value.batteries && i < value.cells.size(); ++i) {
+		packed.push_back(value.cells.at(i));
+	}
+	return {.puzzle = packed.to_string(), .moves = value.moves};
+}
+
+auto cosmic_corpus::count(const std::size_t energies,
+						  const std::size_t empty,
+						  const std::size_t min_moves,
+						  const std::size_t max_moves) const -> std::size_t {
+	const auto shape = find_shape(energies, empty);
+	if(!shape.has_value()) {
+		return 0;
+	}
+	if(min_moves == 0 && max_moves == 0) {
+		return shape->count;
+	}
+	std::size_t result = 0;
+	for(std::size_t i = 0; i < shape->count; ++i) {
+		result += in_band(record(shape->first + i).moves, min_moves, max_moves) ? 1 : 0;
+	}
+	return result;
+}
+
+auto cosmic_corpus::at(const std::size_t energies, const std::size_t empty, const std::size_t index) const
+	-> std::optional<level> {
+	const auto shape = find_shape(energies, empty);
+	if(!shape.has_value() || index >= shape->count) {
+		return std::nullopt;
+	}
+	return decode(record(shape->first + index));
+}
+
+auto cosmic_corpus::draw(const std::size_t energies,
+						 const std::size_t empty,
+						 const std::uint64_t seed,
+						 const std::size_t min_moves,
+						 const std::size_t max_moves) const -> std::optional<level> {
+	const auto total = count(energies, empty, min_moves, max_moves);
+	if(total == 0) {
+		return std::nullopt;
+	}
+	rng engine{seed};
+	auto skip = static_cast<std::size_t>(engine() % total);
+	const auto shape = find_shape(energies, empty);
+	for(std::size_t i = 0; i < shape->count; ++i) {
+		const auto value = record(shape->first + i);
+		if(in_band(value.moves, min_moves, max_moves) && skip-- == 0) {
+			return decode(value);
+		}
+	}
+	return std::nullopt;
+}
+
+auto cosmic_corpus::write(const std::string &path, const std::vector<shape_levels> &shapes) -> pxe::result<> {
+	std::vector<file_shape> table;
+	std::vector<file_record> records;
+	for(const auto &[energies, empty, levels]: shapes) {
+		if(!fits<std::uint8_t>(energies) || !fits<std::uint8_t>(empty)) {
+			return pxe::error(std::format("corpus shape does not fit the file: {} energies {} empty", energies, empty));
+		}
+		if(!fits<std::uint32_t>(records.size() + levels.size())) {
+			return pxe::error("corpus has more records than the file can index");
+		}
+		table.push_back({.energies = static_cast<std::uint8_t>(energies),
+						 .empty = static_cast<std::uint8_t>(empty),
+						 .reserved = 0,
+						 .first = static_cast<std::uint32_t>(records.size()),
+						 .count = static_cast<std::uint32_t>(levels.size())});
+		for(const auto &[text, moves]: levels) {
+			puzzle parsed;
+			if(const auto err = puzzle::from_string(text).unwrap(parsed); err) {
+				return pxe::error(std::format("invalid corpus puzzle: {}", text), *err);
+			}
+			if(!fits<std::uint8_t>(moves)) {
+				return pxe::error(std::format("corpus puzzle moves do not fit the file: {}", text));
+			}
+			const auto packed = parsed.pack();
+			file_record entry{.cells = {},
+							  .batteries = static_cast<std::uint8_t>(packed.size()),
+							  .moves = static_cast<std::uint8_t>(moves),
+							  .reserved = 0};
+			for(std::size_t i = 0; i < packed.size(); ++i) {
+				entry.cells.at(i) = packed.at(i);
+			}
+			records.push_back(entry);
+		}
+	}
+
+	const file_header header{.magic = magic,
+							 .version = version,
+							 .shapes = static_cast<std::uint32_t>(table.size()),
+							 .records = static_cast<std::uint32_t>(records.size())};
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if(!file.is_open()) {
+		return pxe::error(std::format("failed to create cosmic corpus: {}", path));
+	}
+	// NOLINTBEGIN(*-reinterpret-cast)
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char *>(table.data()),
+			   static_cast<std::streamsize>(table.size() * sizeof(file_shape)));
+	file.write(reinterpret_cast<const char *>(records.data()),
+			   static_cast<std::streamsize>(records.size() * sizeof(file_record)));
+	// NOLINTEND(*-reinterpret-cast)
+	if(!file) {
+		return pxe::error(std::format("failed to write cosmic corpus: {}", path));
+	}
+	return true;
+}
+
+} // namespace energy
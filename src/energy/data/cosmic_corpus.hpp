@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <pxe/result.hpp>
+
+#include "mapped_file.hpp"
+#include "packed_puzzle.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace energy {
+
+// Cosmic puzzles generated and verified offline by energy-swap-corpus, grouped by board shape
+// (energies, empty) with their optimal move counts. Opening maps the file and only checks the header,
+// records are decoded when drawn.
+class cosmic_corpus {
+public:
+	struct level {
+		std::string puzzle;
+		std::size_t moves{0};
+	};
+
+	struct shape_levels {
+		std::size_t energies{0};
+		std::size_t empty{0};
+		std::vector<level> levels;
+	};
+
+	cosmic_corpus() = default;
+	~cosmic_corpus() = default;
+
+	// Non-copyable, non-movable
+	cosmic_corpus(const cosmic_corpus &) = delete;
+	auto operator=(const cosmic_corpus &) -> cosmic_corpus & = delete;
+	cosmic_corpus(cosmic_corpus &&) = delete;
+	auto operator=(cosmic_corpus &&) -> cosmic_corpus & = delete;
+
+	auto open(const std::string &path) -> pxe::result<>;
+	auto close() -> void;
+
+	// =============================================================================
+	// Drawing levels, nothing is returned for shapes the corpus does not cover; count and draw only see
+	// levels whose optimal move count is within [min_moves, max_moves], a zero max_moves has no bound
+	[[nodiscard]] auto count(std::size_t energies,
+							 std::size_t empty,
+							 std::size_t min_moves = 0,
+							 std::size_t max_moves = 0) const -> std::size_t;
+	[[nodiscard]] auto at(std::size_t energies, std::size_t empty, std::size_t index) const -> std::optional<level>;
+	[[nodiscard]] auto draw(std::size_t energies,
+							std::size_t empty,
+							std::uint64_t seed,
+							std::size_t min_moves = 0,
+							std::size_t max_moves = 0) const -> std::optional<level>;
+
+	// =============================================================================
+	// Offline building, levels must be valid puzzle strings and every count must fit its on-disk field
+	[[nodiscard]] static auto write(const std::string &path, const std::vector<shape_levels> &shapes)
+		-> pxe::result<>;
+
+private:
+	// on-disk layout in the byte order of the machine that wrote it: header, shape table, then fixed-size
+	// records; a file from a machine of the other order fails the version check
+	static constexpr std::array<char, 4> magic{'E', 'S', 'C', 'P'};
+	static constexpr std::uint32_t version = 1;
+
+	struct file_header {
+		std::array<char, 4> magic;
+		std::uint32_t version;
+		std::uint32_t shapes;
+		std::uint32_t records;
+	};
+
+	struct file_shape {
+		std::uint8_t energies;
+		std::uint8_t empty;
+		std::uint16_t reserved;
+		std::uint32_t first;
+		std::uint32_t count;
+	};
+
+	struct file_record {
+		std::array<packed_puzzle::cell, packed_puzzle::max_batteries> cells;
+		std::uint8_t batteries;
+		std::uint8_t moves;
+		std::uint16_t reserved;
+	};
+
+	[[nodiscard]] auto validate() const -> pxe::result<>;
+	[[nodiscard]] auto find_shape(std::size_t energies, std::size_t empty) const -> std::optional<file_shape>;
+	[[nodiscard]] auto header() const -> file_header;
+	[[nodiscard]] auto shape_at(std::size_t index) const -> file_shape;
+	[[nodiscard]] auto record(std::size_t index) const -> file_record;
+	[[nodiscard]] static auto decode(const file_record &value) -> level;
+	[[nodiscard]] static auto in_band(std::size_t moves, std::size_t min_moves, std::size_t max_moves) -> bool {
+		return moves >= min_moves && (max_moves == 0 || moves <= max_moves);
+	}
+
+	mapped_file file_;
+};
+
+} // namespace energy
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "cosmic_pool.hpp"
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace energy {
+
+cosmic_pool::cosmic_pool(generator generate): generate_{std::move(generate)} {
+	assert(generate_ && "Cosmic pool needs a generator");
+}
+
+auto cosmic_pool::set_wanted(const std::vector<level> &levels) -> void {
+	{
+		const std::scoped_lock lock(mutex_);
+		wanted_ = levels;
+		std::erase_if(ready_, [this](const auto &entry) -> bool {
+			return std::ranges::find(wanted_, entry.first) == wanted_.end();
+		});
+	}
+	if constexpr(threads_available) {
+		// the producer only starts once something is wanted, tools that never play cosmic never pay for it
+		if(!producer_.joinable() && !levels.empty()) {
+			producer_ = std::jthread([this](const std::stop_token &stop) -> void { produce(stop); });
+		}
+	}
+	wake_.notify_one();
+}
+
+auto cosmic_pool::take(const level &wanted) -> std::optional<std::string> {
+	const std::scoped_lock lock(mutex_);
+	std::erase(wanted_, wanted);
+	auto found = ready_.extract(wanted);
+	if(found.empty()) {
+		return std::nullopt;
+	}
+	return std::move(found.mapped());
+}
+
+auto cosmic_pool::ready(const level &wanted) const -> bool {
+	const std::scoped_lock lock(mutex_);
+	return ready_.contains(wanted);
+}
+
+auto cosmic_pool::next_missing() const -> std::optional<level> {
+	for(const auto &wanted: wanted_) {
+		if(!ready_.contains(wanted)) {
+			return wanted;
+		}
+	}
+	return std::nullopt;
+}
+
+auto cosmic_pool::produce(const std::stop_token &stop) -> void {
+	std::unique_lock lock(mutex_);
+	while(!stop.stop_requested()) {
+		const auto next = next_missing();
+		if(!next.has_value()) {
+			wake_.wait(lock, stop, [this]() -> bool { return next_missing().has_value(); });
+			continue;
+		}
+		// generate without the lock, the game may take or change what is wanted meanwhile
+		lock.unlock();
+		auto puzzle = generate_(*next, stop);
+		lock.lock();
+		// a stopped generation may have given up halfway, its puzzle is not kept
+		if(!stop.stop_requested() && std::ranges::find(wanted_, *next) != wanted_.end()) {
+			ready_.insert_or_assign(*next, std::move(puzzle));
+		}
+	}
+}
+
+} // namespace energy
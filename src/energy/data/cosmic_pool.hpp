@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <compare>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace energy {
+
+// Keeps the cosmic puzzles of the levels about to be played ready, a producer thread generates them ahead
+// so taking one never waits on a solve. Each level is generated from its own seed, so a puzzle taken from
+// the pool is the one the level gets when it is generated on the spot. Without threads nothing is
+// produced and every take comes back empty.
+class cosmic_pool {
+public:
+	// board shape plus how it is generated: scramble is the reverse-transfer depth of solvable-by-construction
+	// puzzles, zero for random ones, and the optimal move band is searched for within a candidate budget
+	struct shape {
+		std::size_t energies;
+		std::size_t empty;
+		std::size_t scramble;
+		std::size_t min_moves;
+		std::size_t max_moves;
+		std::size_t budget;
+		auto operator<=>(const shape &other) const = default;
+	};
+
+	struct level {
+		shape wanted;
+		std::uint64_t seed;
+		auto operator<=>(const level &other) const = default;
+	};
+
+	// the producer passes its stop token, generation is expected to give up soon after a stop request
+	using generator = std::function<std::string(const level &next, const std::stop_token &stop)>;
+
+	explicit cosmic_pool(generator generate);
+
+	// Non-copyable, non-movable
+	cosmic_pool(const cosmic_pool &) = delete;
+	auto operator=(const cosmic_pool &) -> cosmic_pool & = delete;
+	cosmic_pool(cosmic_pool &&) = delete;
+	auto operator=(cosmic_pool &&) -> cosmic_pool & = delete;
+	~cosmic_pool() = default;
+
+	// =============================================================================
+	// Levels to have ready, in order of need; puzzles of any other level are dropped
+	auto set_wanted(const std::vector<level> &levels) -> void;
+
+	[[nodiscard]] auto take(const level &wanted) -> std::optional<std::string>;
+	[[nodiscard]] auto ready(const level &wanted) const -> bool;
+
+private:
+	auto produce(const std::stop_token &stop) -> void;
+	[[nodiscard]] auto next_missing() const -> std::optional<level>;
+
+	generator generate_;
+	mutable std::mutex mutex_;
+	std::condition_variable_any wake_;
+	std::vector<level> wanted_;
+	std::map<level, std::string> ready_;
+	// last, so the producer is stopped and joined before anything it uses goes away
+	std::jthread producer_;
+};
+
+} // namespace energy
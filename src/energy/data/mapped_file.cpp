@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "mapped_file.hpp"
+
+#include <pxe/result.hpp>
+
+#include <cstddef>
+#include <format>
+#include <fstream>
+#include <ios>
+#include <span>
+#include <string>
+
+#if __has_include(<sys/mman.h>) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ENERGY_FILE_MMAP
+#endif
+
+namespace energy {
+
+namespace {
+
+#ifdef ENERGY_FILE_MMAP
+auto map_file(const std::string &path) -> std::span<const std::byte> {
+	const auto descriptor = ::open(path.c_str(), O_RDONLY); // NOLINT(*-vararg)
+	if(descriptor < 0) {
+		return {};
+	}
+	std::span<const std::byte> result;
+	struct stat info{};
+	if(::fstat(descriptor, &info) == 0 && info.st_size > 0) {
+		const auto size = static_cast<std::size_t>(info.st_size);
+		if(auto *memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0); memory != MAP_FAILED) {
+			result = {static_cast<const std::byte *>(memory), size};
+		}
+	}
+	::close(descriptor);
+	return result;
+}
+
+auto unmap_file(const std::span<const std::byte> data) -> void {
+	::munmap(const_cast<std::byte *>(data.data()), data.size()); // NOLINT(*-const-cast)
+}
+#else
+auto map_file(const std::string & /*path*/) -> std::span<const std::byte> {
+	return {};
+}
+
+auto unmap_file(const std::span<const std::byte> /*data*/) -> void {}
+#endif
+
+} // namespace
+
+mapped_file::~mapped_file() {
+	close();
+}
+
+auto mapped_file::open(const std::string &path) -> pxe::result<> {
+	close();
+	data_ = map_file(path);
+	mapped_ = !data_.empty();
+	if(mapped_) {
+		return true;
+	}
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if(!file.is_open()) {
+		return pxe::error(std::format("failed to open file: {}", path));
+	}
+	buffer_.resize(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0);
+	auto *bytes = reinterpret_cast<char *>(buffer_.data()); // NOLINT(*-reinterpret-cast)
+	if(!file.read(bytes, static_cast<std::streamsize>(buffer_.size()))) {
+		close();
+		return pxe::error(std::format("failed to read file: {}", path));
+	}
+	data_ = buffer_;
+	return true;
+}
+
+auto mapped_file::close() -> void {
+	if(mapped_) {
+		unmap_file(data_);
+	}
+	data_ = {};
+	buffer_.clear();
+	mapped_ = false;
+}
+
+} // namespace energy
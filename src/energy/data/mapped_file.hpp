@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <pxe/result.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace energy {
+
+// Read-only bytes of a whole file, memory-mapped where the platform allows it and read in one go otherwise.
+class mapped_file {
+public:
+	mapped_file() = default;
+	~mapped_file();
+
+	// Non-copyable, non-movable
+	mapped_file(const mapped_file &) = delete;
+	auto operator=(const mapped_file &) -> mapped_file & = delete;
+	mapped_file(mapped_file &&) = delete;
+	auto operator=(mapped_file &&) -> mapped_file & = delete;
+
+	auto open(const std::string &path) -> pxe::result<>;
+	auto close() -> void;
+
+	[[nodiscard]] auto bytes() const -> std::span<const std::byte> {
+		return data_;
+	}
+
+	// copy of the value stored at offset, the caller checks it fits; mapped bytes carry no alignment
+	template<typename T>
+	[[nodiscard]] auto read(const std::size_t offset) const -> T {
+		static_assert(std::is_trivially_copyable_v<T>, "only plain values can be copied out of file bytes");
+		T result{};
+		std::memcpy(&result, data_.subspan(offset, sizeof(T)).data(), sizeof(T));
+		return result;
+	}
+
+private:
+	std::span<const std::byte> data_;
+	// owns data_ when the file could not be mapped
+	std::vector<std::byte> buffer_;
+	bool mapped_{false};
+};
+
+} // namespace energy
@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "packed_puzzle.hpp"
+
+#include "zobrist.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace energy {
+
+auto packed_puzzle::to_string() const -> std::string {
+	static constexpr std::string_view digits = "0123456789ABCDEF";
+	std::string result(std::size_t{size_} * slots, '0');
+	for(std::size_t i = 0; i < size_; ++i) {
+		for(auto slot = 0; slot < count(cells_.at(i)); ++slot) {
+			result.at((i * slots) + static_cast<std::size_t>(slot)) =
+				digits.at(static_cast<std::size_t>(energy(cells_.at(i), slot)));
+		}
+	}
+	return result;
+}
+
+auto packed_puzzle::transfer(const std::size_t from, const std::size_t to) -> int {
+	assert(can_transfer(from, to) && "Cannot transfer energy between packed batteries");
+	const auto moved = run(cells_.at(from));
+	move_energies(from, to, moved);
+	return moved;
+}
+
+auto packed_puzzle::undo(const std::size_t from, const std::size_t to, const int moved) -> void {
+	assert(count(cells_.at(to)) >= moved && "Cannot undo more energies than the target holds");
+	move_energies(to, from, moved);
+}
+
+auto packed_puzzle::move_energies(const std::size_t from, const std::size_t to, const int moved) -> void {
+	auto &source = cells_.at(from);
+	auto &target = cells_.at(to);
+	const auto remaining = count(source) - moved;
+	const auto filled = count(target);
+	const auto shift = filled * bits_per_energy;
+
+	settled_ = static_cast<std::uint8_t>(settled_ - (settled(source) ? 1 : 0) - (settled(target) ? 1 : 0));
+	auto source_hash = battery_hash(source);
+	auto target_hash = battery_hash(target);
+	hash_ -= zobrist::combine(source_hash) + zobrist::combine(target_hash);
+	const auto color = top(source);
+	for(auto i = 0; i < moved; ++i) {
+		source_hash ^= zobrist::key(static_cast<std::size_t>(remaining + i), color);
+		target_hash ^= zobrist::key(static_cast<std::size_t>(filled + i), color);
+	}
+	hash_ += zobrist::combine(source_hash) + zobrist::combine(target_hash);
+
+	const auto mask = static_cast<cell>((1U << (moved * bits_per_energy)) - 1U);
+	const auto energies = static_cast<cell>(source >> (remaining * bits_per_energy)) & mask;
+	target = static_cast<cell>(target | (energies << shift));
+	source = static_cast<cell>(source & ((1U << (remaining * bits_per_energy)) - 1U));
+	settled_ = static_cast<std::uint8_t>(settled_ + (settled(source) ? 1 : 0) + (settled(target) ? 1 : 0));
+}
+
+auto packed_puzzle::legal_moves() const -> move_matrix {
+	// batteries topped by each color, color 0 being the empty ones, and batteries with room for at
+	// least n more energies; closed batteries are in neither, so they are never a target
+	std::array<move_mask, zobrist::energy_types> topped_by{};
+	std::array<move_mask, slots + 1> room_for{};
+	std::array<std::uint8_t, max_batteries> source_top{};
+	std::array<std::uint8_t, max_batteries> source_run{};
+	move_mask sources = 0;
+	for(std::size_t i = 0; i < size_; ++i) {
+		const auto value = cells_.at(i);
+		if(closed(value)) {
+			continue;
+		}
+		const auto bit = static_cast<move_mask>(1U << i);
+		const auto color = top(value);
+		topped_by.at(static_cast<std::size_t>(color)) |= bit;
+		for(auto room = 1; room <= slots - count(value); ++room) {
+			room_for.at(static_cast<std::size_t>(room)) |= bit;
+		}
+		if(value != 0) {
+			sources |= bit;
+			source_top.at(i) = static_cast<std::uint8_t>(color);
+			source_run.at(i) = static_cast<std::uint8_t>(run(value));
+		}
+	}
+
+	move_matrix result{};
+	for(auto remaining = sources; remaining != 0; remaining &= static_cast<move_mask>(remaining - 1U)) {
+		const auto from = static_cast<std::size_t>(std::countr_zero(remaining));
+		const auto matching = topped_by.at(source_top.at(from)) | topped_by.at(0);
+		result.at(from) = static_cast<move_mask>(matching & room_for.at(source_run.at(from)) & ~(1U << from));
+	}
+	return result;
+}
+
+auto packed_puzzle::legal_move_count() const -> std::size_t {
+	std::size_t total = 0;
+	for(const auto targets: legal_moves()) {
+		total += static_cast<std::size_t>(std::popcount(targets));
+	}
+	return total;
+}
+
+auto packed_puzzle::canonical() const -> key {
+	return make_key(sorted_cells(), hash_);
+}
+
+// colors are ordered by where they sit, which does not depend on their labels: the slot of every energy,
+// the fill of its battery and whether it rests on the same color; only ties fall back to the label
+auto packed_puzzle::color_relabeling() const -> relabeling {
+	std::array<std::uint64_t, zobrist::energy_types> placement{};
+	std::uint16_t present = 0;
+	for(std::size_t i = 0; i < size_; ++i) {
+		const auto value = cells_.at(i);
+		const auto total = count(value);
+		for(auto slot = 0; slot < total; ++slot) {
+			const auto color = energy(value, slot);
+			const auto stacked = slot > 0 && energy(value, slot - 1) == color ? slots + 1 : 0;
+			placement.at(static_cast<std::size_t>(color)) +=
+				zobrist::key(static_cast<std::size_t>(slot), total + stacked);
+			present = static_cast<std::uint16_t>(present | (1U << color));
+		}
+	}
+
+	std::array<std::uint8_t, zobrist::energy_types> order{};
+	std::size_t colors_present = 0;
+	for(std::size_t color = 1; color < order.size(); ++color) {
+		if((present & (1U << color)) != 0) {
+			order.at(colors_present++) = static_cast<std::uint8_t>(color);
+		}
+	}
+	std::ranges::sort(std::span{order}.first(colors_present), [&](const auto lhs, const auto rhs) -> bool {
+		return placement.at(lhs) != placement.at(rhs) ? placement.at(lhs) < placement.at(rhs) : lhs < rhs;
+	});
+
+	relabeling colors{};
+	for(std::size_t i = 0; i < colors_present; ++i) {
+		colors.at(order.at(i)) = static_cast<std::uint8_t>(i + 1);
+	}
+	return colors;
+}
+
+auto packed_puzzle::color_canonical() const -> key {
+	const auto colors = color_relabeling();
+	cell_array relabeled{};
+	for(std::size_t i = 0; i < size_; ++i) {
+		relabeled.at(i) = relabel(cells_.at(i), colors);
+	}
+	std::ranges::sort(std::span{relabeled}.first(size_), std::greater<>{});
+	auto result = make_key(relabeled, 0);
+	result.hash ^= zobrist::mix(result.bits.at(0) ^ zobrist::mix(result.bits.at(1) ^ zobrist::mix(result.bits.at(2))));
+	return result;
+}
+
+auto packed_puzzle::relabel(const cell value, const relabeling &colors) -> cell {
+	cell result = 0;
+	for(auto slot = 0; slot < count(value); ++slot) {
+		const auto color = colors.at(static_cast<std::size_t>(energy(value, slot)));
+		result = static_cast<cell>(result | (color << (slot * bits_per_energy)));
+	}
+	return result;
+}
+
+auto packed_puzzle::sorted_cells() const -> cell_array {
+	auto sorted = cells_;
+	std::ranges::sort(std::span{sorted}.first(size_), std::greater<>{});
+	return sorted;
+}
+
+auto packed_puzzle::make_key(const cell_array &sorted, const std::uint64_t hash) const -> key {
+	key result{.bits = {}, .hash = hash ^ zobrist::mix(size_), .batteries = size_};
+	for(std::size_t i = 0; i < sorted.size(); ++i) {
+		result.bits.at(i / 4) |= static_cast<std::uint64_t>(sorted.at(i)) << ((i % 4) * 16);
+	}
+	return result;
+}
+
+} // namespace energy
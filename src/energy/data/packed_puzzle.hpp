@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "zobrist.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace energy {
+
+// Fixed-width puzzle state used by the solver, each battery is a 16-bit word holding
+// four 4-bit energies with the bottom energy in the lowest nibble.
+class packed_puzzle {
+public:
+	using cell = std::uint16_t;
+	static constexpr auto max_batteries = 12;
+	static constexpr auto slots = 4;
+	static constexpr auto bits_per_energy = 4;
+
+	// =============================================================================
+	// Canonical key, batteries sorted so battery order does not matter (192 bits), carrying the
+	// incremental Zobrist hash so hashed containers never rehash the bits. Unused cells are zero like empty
+	// batteries, so the battery count is part of the key and of its hash
+	struct key {
+		std::array<std::uint64_t, 3> bits{};
+		std::uint64_t hash{};
+		std::uint8_t batteries{};
+		auto operator==(const key &other) const -> bool {
+			return bits == other.bits && batteries == other.batteries;
+		}
+	};
+
+	struct key_hash {
+		[[nodiscard]] auto operator()(const key &value) const noexcept -> std::size_t {
+			return static_cast<std::size_t>(value.hash);
+		}
+	};
+
+	// =============================================================================
+	// Construction and access
+	auto push_back(const cell value) -> void {
+		cells_.at(size_++) = value;
+		settled_ = static_cast<std::uint8_t>(settled_ + (settled(value) ? 1 : 0));
+		hash_ += zobrist::combine(battery_hash(value));
+	}
+
+	[[nodiscard]] auto size() const -> std::size_t {
+		return size_;
+	}
+
+	[[nodiscard]] auto at(const std::size_t index) const -> cell {
+		return cells_.at(index);
+	}
+
+	auto operator==(const packed_puzzle &other) const -> bool = default;
+
+	// same text as puzzle::to_string for the puzzle this was packed from
+	[[nodiscard]] auto to_string() const -> std::string;
+
+	// =============================================================================
+	// Moves and state queries
+	[[nodiscard]] auto can_transfer(const std::size_t from, const std::size_t to) const -> bool {
+		return can_get_from(cells_.at(to), cells_.at(from));
+	}
+
+	// every legal move at once, row `from` has bit `to` set when that transfer is allowed; built from
+	// per-battery masks of top color and free room instead of testing each pair
+	using move_mask = std::uint16_t;
+	using move_matrix = std::array<move_mask, max_batteries>;
+	[[nodiscard]] auto legal_moves() const -> move_matrix;
+	[[nodiscard]] auto legal_move_count() const -> std::size_t;
+
+	// returns how many energies were moved so the transfer can be undone in place
+	auto transfer(std::size_t from, std::size_t to) -> int;
+	auto undo(std::size_t from, std::size_t to, int moved) -> void;
+
+	// solved once every battery is settled, tracked by push_back and every transfer
+	[[nodiscard]] auto is_solved() const -> bool {
+		return settled_ == size_;
+	}
+	[[nodiscard]] auto canonical() const -> key;
+
+	// =============================================================================
+	// Color symmetry, relabeling colors never changes how long a solution is, so states that only differ
+	// by it can share a key; colors are renumbered in an order that does not depend on their labels. The
+	// key hash comes from the renumbered bits, since the Zobrist hash still depends on the real colors
+	using relabeling = std::array<std::uint8_t, zobrist::energy_types>;
+	[[nodiscard]] auto color_relabeling() const -> relabeling;
+	[[nodiscard]] auto color_canonical() const -> key;
+	[[nodiscard]] static auto relabel(cell value, const relabeling &colors) -> cell;
+
+	[[nodiscard]] auto hash() const -> std::uint64_t {
+		return hash_;
+	}
+
+	// same value as battery::hash for the battery this cell was packed from
+	[[nodiscard]] static constexpr auto battery_hash(const cell value) -> std::uint64_t {
+		std::uint64_t result = 0;
+		for(auto slot = 0; slot < count(value); ++slot) {
+			result ^= zobrist::key(static_cast<std::size_t>(slot), energy(value, slot));
+		}
+		return result;
+	}
+
+	// =============================================================================
+	// Single battery queries
+	[[nodiscard]] static constexpr auto count(const cell value) -> int {
+		return (std::bit_width(value) + bits_per_energy - 1) / bits_per_energy;
+	}
+
+	[[nodiscard]] static constexpr auto energy(const cell value, const int slot) -> int {
+		return (value >> (slot * bits_per_energy)) & 0xF;
+	}
+
+	[[nodiscard]] static constexpr auto top(const cell value) -> int {
+		const auto total = count(value);
+		return total == 0 ? 0 : energy(value, total - 1);
+	}
+
+	[[nodiscard]] static constexpr auto run(const cell value) -> int {
+		const auto total = count(value);
+		if(total == 0) {
+			return 0;
+		}
+		const auto color = energy(value, total - 1);
+		auto length = 1;
+		while(length < total && energy(value, total - 1 - length) == color) {
+			++length;
+		}
+		return length;
+	}
+
+	[[nodiscard]] static constexpr auto closed(const cell value) -> bool {
+		return count(value) == slots && run(value) == slots;
+	}
+
+	// empty or closed, nothing left to do with it
+	[[nodiscard]] static constexpr auto settled(const cell value) -> bool {
+		return value == 0 || closed(value);
+	}
+
+	[[nodiscard]] static constexpr auto can_get_from(const cell to, const cell from) -> bool {
+		if(from == 0 || closed(from) || closed(to) || count(to) == slots) {
+			return false;
+		}
+		if(to == 0) {
+			return true;
+		}
+		return count(to) + run(from) <= slots && top(to) == top(from);
+	}
+
+private:
+	auto move_energies(std::size_t from, std::size_t to, int moved) -> void;
+
+	using cell_array = std::array<cell, max_batteries>;
+	[[nodiscard]] auto sorted_cells() const -> cell_array;
+	[[nodiscard]] auto make_key(const cell_array &sorted, std::uint64_t hash) const -> key;
+
+	std::array<cell, max_batteries> cells_{};
+	std::uint8_t size_{0};
+	std::uint8_t settled_{0};
+	std::uint64_t hash_{0};
+};
+
+} // namespace energy
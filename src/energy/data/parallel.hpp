@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace energy {
+
+// the web build runs without pthreads, so everything falls back to the calling thread there
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+inline constexpr auto threads_available = false;
+#else
+inline constexpr auto threads_available = true;
+#endif
+
+[[nodiscard]] inline auto hardware_threads() -> std::size_t {
+	if constexpr(!threads_available) {
+		return 1;
+	}
+	return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+// splits [0, count) into one contiguous chunk per worker and runs work(worker, begin, end) for each,
+// worker 0 runs on the calling thread and the call returns once every chunk is done
+template<typename Work>
+auto parallel_for(const std::size_t count, std::size_t workers, Work &&work) -> void {
+	workers = threads_available ? std::clamp<std::size_t>(workers, 1, std::max<std::size_t>(count, 1)) : 1;
+	const auto chunk = (count + workers - 1) / workers;
+	std::vector<std::jthread> threads;
+	threads.reserve(workers - 1);
+	for(std::size_t worker = 1; worker < workers; ++worker) {
+		const auto begin = std::min(count, worker * chunk);
+		const auto end = std::min(count, begin + chunk);
+		threads.emplace_back([&work, worker, begin, end]() -> void { work(worker, begin, end); });
+	}
+	work(std::size_t{0}, std::size_t{0}, std::min(count, chunk));
+}
+
+// parallel_for for callers that split many small batches in a row: the workers - 1 threads start once and
+// park between runs instead of being created and joined for every batch
+class worker_pool {
+public:
+	explicit worker_pool(std::size_t workers) {
+		workers = threads_available ? std::max<std::size_t>(workers, 1) : 1;
+		threads_.reserve(workers - 1);
+		for(std::size_t worker = 1; worker < workers; ++worker) {
+			threads_.emplace_back([this, worker](const std::stop_token &stop) -> void { serve(worker, stop); });
+		}
+	}
+	worker_pool(const worker_pool &) = delete;
+	worker_pool(worker_pool &&) = delete;
+	auto operator=(const worker_pool &) -> worker_pool & = delete;
+	auto operator=(worker_pool &&) -> worker_pool & = delete;
+	~worker_pool() = default;
+
+	[[nodiscard]] auto size() const -> std::size_t {
+		return threads_.size() + 1;
+	}
+
+	// same split as parallel_for, worker 0 runs on the calling thread and the call returns once every chunk is done
+	template<typename Work>
+	auto run(const std::size_t count, Work &&work) -> void {
+		const auto workers = std::clamp<std::size_t>(count, 1, size());
+		const auto chunk = (count + workers - 1) / workers;
+		const auto split = [&work, count, chunk](const std::size_t worker) -> void {
+			const auto begin = std::min(count, worker * chunk);
+			work(worker, begin, std::min(count, begin + chunk));
+		};
+		{
+			const std::scoped_lock lock(mutex_);
+			work_ = split;
+			workers_ = workers;
+			pending_ = workers - 1;
+			++generation_;
+		}
+		wake_.notify_all();
+		split(0);
+		std::unique_lock lock(mutex_);
+		done_.wait(lock, [this]() -> bool { return pending_ == 0; });
+	}
+
+private:
+	auto serve(const std::size_t worker, const std::stop_token &stop) -> void {
+		std::uint64_t seen = 0;
+		std::unique_lock lock(mutex_);
+		while(wake_.wait(lock, stop, [this, &seen]() -> bool { return generation_ != seen; })) {
+			seen = generation_;
+			if(worker >= workers_) {
+				continue;
+			}
+			// run only swaps the work once every worker is done, so it is read without the lock
+			lock.unlock();
+			work_(worker);
+			lock.lock();
+			if(--pending_ == 0) {
+				done_.notify_one();
+			}
+		}
+	}
+
+	std::mutex mutex_;
+	std::condition_variable_any wake_;
+	std::condition_variable done_;
+	std::function<void(std::size_t)> work_;
+	std::size_t workers_{0};
+	std::size_t pending_{0};
+	std::uint64_t generation_{0};
+	// declared last so the threads stop and join before anything they wait on goes away
+	std::vector<std::jthread> threads_;
+};
+
+} // namespace energy
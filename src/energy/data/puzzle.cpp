@@ -6,25 +6,25 @@
 #include <pxe/result.hpp>
 
 #include "battery.hpp"
+#include "packed_puzzle.hpp"
+#include "rng.hpp"
+#include "solver.hpp"
+#include "zobrist.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
-#include <cstdlib>
-#include <deque>
+#include <cstdint>
 #include <optional>
-#include <random>
 #include <string>
-#include <unordered_set>
-#include <utility>
 #include <vector>
 
 namespace energy {
 
 auto puzzle::id() const -> std::string {
 	std::vector<std::string> battery_ids;
-	battery_ids.reserve(batteries_.size());
-	for(const auto &bat: batteries_) {
+	battery_ids.reserve(size());
+	for(const auto &bat: batteries()) {
 		battery_ids.push_back(bat.string());
 	}
 	std::ranges::sort(battery_ids);
@@ -35,41 +35,84 @@ auto puzzle::id() const -> std::string {
 	return result;
 }
 
-auto puzzle::solve(bool optimized) const -> std::vector<move> {
-	using move_list = std::vector<move>;
-	using state_key = std::string;
-	std::unordered_set<state_key> visited;
-
-	using frame = std::pair<puzzle, move_list>;
-	std::deque<frame> queue;
-	queue.emplace_back(*this, move_list{});
-
-	while(!queue.empty()) {
-		frame current;
-		if(optimized) {
-			current = std::move(queue.front());
-			queue.pop_front();
-		} else {
-			current = std::move(queue.back());
-			queue.pop_back();
-		}
+auto puzzle::pack() const -> packed_puzzle {
+	packed_puzzle result;
+	for(const auto &bat: batteries()) {
+		result.push_back(bat.pack());
+	}
+	return result;
+}
 
-		const auto &state = current.first;
-		const auto &moves = current.second;
+auto puzzle::transfer(const move &mv) -> void {
+	assert(mv.from < size_ && mv.to < size_ && "move out of range");
+	auto &from = batteries_.at(mv.from);
+	auto &to = batteries_.at(mv.to);
+	hash_ -= zobrist::combine(from.hash()) + zobrist::combine(to.hash());
+	count_battery(from, -1);
+	count_battery(to, -1);
+	const auto before = moves_touching(mv.from, mv.to);
+	to.transfer_energy_from(from);
+	count_battery(from, 1);
+	count_battery(to, 1);
+	hash_ += zobrist::combine(from.hash()) + zobrist::combine(to.hash());
+	legal_moves_ = static_cast<std::uint8_t>(legal_moves_ - before + moves_touching(mv.from, mv.to));
+}
 
-		const auto key = state.id();
-		if(visited.contains(key)) {
-			continue;
-		}
-		visited.insert(key);
+auto puzzle::push_battery(const battery &bat) -> void {
+	assert(size_ < max_batteries && "puzzle battery storage is full");
+	const auto added = static_cast<std::size_t>(size_);
+	batteries_.at(size_++) = bat;
+	count_battery(bat, 1);
+	hash_ += zobrist::combine(bat.hash());
+	auto gained = 0;
+	for(std::size_t i = 0; i < added; ++i) {
+		gained += moves_between(i, added);
+	}
+	legal_moves_ = static_cast<std::uint8_t>(legal_moves_ + gained);
+}
+
+auto puzzle::moves_between(const std::size_t first, const std::size_t second) const -> int {
+	const auto &lhs = batteries_.at(first);
+	const auto &rhs = batteries_.at(second);
+	return (lhs.can_get_from(rhs) ? 1 : 0) + (rhs.can_get_from(lhs) ? 1 : 0);
+}
 
-		if(state.is_solved()) {
-			return moves;
+// only pairs with an end in one of the two batteries can change when a move touches them, so the rest of the
+// board is never looked at
+auto puzzle::moves_touching(const std::size_t first, const std::size_t second) const -> int {
+	auto total = moves_between(first, second);
+	for(std::size_t i = 0; i < size_; ++i) {
+		if(i != first && i != second) {
+			total += moves_between(i, first) + moves_between(i, second);
 		}
+	}
+	return total;
+}
 
-		push_next_moves(state, moves, queue);
+auto puzzle::count_battery(const battery &bat, const int sign) -> void {
+	if(bat.closed()) {
+		closed_ = static_cast<std::uint8_t>(closed_ + sign);
+	} else if(bat.empty()) {
+		empty_ = static_cast<std::uint8_t>(empty_ + sign);
+	}
+}
+
+auto puzzle::solve(const strategy mode) const -> std::vector<move> {
+	switch(mode) {
+	case strategy::depth_first:
+		return solver::depth_first(pack());
+	case strategy::a_star:
+		return solver::a_star(pack());
+	case strategy::ida_star:
+		return solver::ida_star(pack());
+	case strategy::parallel_breadth_first:
+		return solver::parallel_breadth_first(pack());
+	case strategy::bidirectional:
+		return solver::bidirectional(pack());
+	case strategy::breadth_first:
+	default:
+		return solver::breadth_first(pack());
 	}
-	return {};
 }
 
 auto puzzle::from_string(const std::string &str) -> pxe::result<puzzle> {
@@ -92,7 +135,7 @@ auto puzzle::from_string(const std::string &str) -> pxe::result<puzzle> {
 		if(const auto error = battery::from_string(battery_str).unwrap(parsed); error) {
 			return pxe::error("failed to parse battery in puzzle from string", *error);
 		}
-		result.batteries_.push_back(parsed);
+		result.push_battery(parsed);
 	}
 
 	return result;
@@ -100,23 +143,20 @@ auto puzzle::from_string(const std::string &str) -> pxe::result<puzzle> {
 
 auto puzzle::to_string() const -> std::string {
 	std::string result;
-	for(const auto &bat: batteries_) {
+	for(const auto &bat: batteries()) {
 		result += bat.string();
 	}
 	return result;
 }
 
-auto puzzle::random(const size_t total_energies, const size_t free_slots) -> puzzle {
-	const auto total_batteries = total_energies + free_slots;
-	assert(total_batteries <= puzzle::max_batteries && "total energies and free slots exceed maximum capacity");
-
+auto puzzle::choose_types(const size_t total_energies, rng &engine) -> std::vector<int> {
 	// Step 1: Build and shuffle all possible energy types
 	std::vector<int> all_types;
 	all_types.reserve(battery::max_energy_types);
 	for(int t = 1; t <= battery::max_energy_types; ++t) {
 		all_types.push_back(t);
 	}
-	std::ranges::shuffle(all_types, std::mt19937{static_cast<unsigned>(std::rand())});
+	shuffle(all_types, engine);
 
 	// Step 2: Select the first total_energies types
 	std::vector<int> chosen_types;
@@ -124,6 +164,50 @@ auto puzzle::random(const size_t total_energies, const size_t free_slots) -> puz
 	for(size_t i = 0; i < total_energies; ++i) {
 		chosen_types.push_back(all_types.at(i));
 	}
+	return chosen_types;
+}
+
+auto puzzle::scrambled(const size_t total_energies, const size_t free_slots, const size_t depth, rng &engine)
+	-> puzzle {
+	assert(total_energies + free_slots <= puzzle::max_batteries
+		   && "total energies and free slots exceed maximum capacity");
+	packed_puzzle solved;
+	for(const auto type: choose_types(total_energies, engine)) {
+		solved.push_back(static_cast<packed_puzzle::cell>(type * 0x1111));
+	}
+	for(size_t i = 0; i < free_slots; ++i) {
+		solved.push_back(0);
+	}
+	const auto state = solver::scramble(solved, depth, engine);
+
+	// the walk leaves the untouched batteries where the solved board had them
+	std::vector<packed_puzzle::cell> cells;
+	cells.reserve(state.size());
+	for(size_t i = 0; i < state.size(); ++i) {
+		cells.push_back(state.at(i));
+	}
+	shuffle(cells, engine);
+	puzzle result;
+	for(const auto value: cells) {
+		result.push_battery(unpack(value));
+	}
+	return result;
+}
+
+auto puzzle::unpack(const packed_puzzle::cell value) -> battery {
+	battery result;
+	for(auto slot = 0; slot < packed_puzzle::count(value); ++slot) {
+		result.add(packed_puzzle::energy(value, slot));
+	}
+	return result;
+}
+
+auto puzzle::random(const size_t total_energies, const size_t free_slots, rng &engine) -> puzzle {
+	const auto total_batteries = total_energies + free_slots;
+	assert(total_batteries <= puzzle::max_batteries && "total energies and free slots exceed maximum capacity");
+
+	// Step 1 and 2: Pick the energy types
+	const auto chosen_types = choose_types(total_energies, engine);
 
 	// Step 3: Build a vector of all energy units using only chosen types
 	std::vector<int> energies;
@@ -138,70 +222,23 @@ auto puzzle::random(const size_t total_energies, const size_t free_slots) -> puz
 		energies.push_back(0);
 	}
 	// Shuffle energies
-	std::ranges::shuffle(energies, std::mt19937{static_cast<unsigned>(std::rand())});
+	shuffle(energies, engine);
 
 	puzzle result;
-	result.batteries_.resize(total_batteries);
 	// Distribute energies into batteries
 	size_t idx = 0;
-	for(auto &bat: result.batteries_) {
+	for(size_t b = 0; b < total_batteries; ++b) {
+		battery bat;
 		for(size_t i = 0; i < battery::max_energy; ++i) {
 			if(const auto val = energies.at(idx); val > 0) {
 				bat.add(val);
 			}
 			++idx;
 		}
+		result.push_battery(bat);
 	}
 
 	return result;
 }
 
-auto puzzle::is_solved() const -> bool {
-	return std::ranges::all_of(batteries_,
-							   [](const auto &battery) -> bool { return battery.closed() || battery.empty(); });
-}
-
-auto puzzle::is_solvable() const -> bool {
-	return std::ranges::any_of(batteries_, [this](const auto &from_bat) -> auto {
-		if(from_bat.closed() || from_bat.empty()) {
-			return false;
-		}
-		return std::ranges::any_of(batteries_, [&from_bat](const auto &to_bat) -> auto {
-			if(std::addressof(from_bat) == std::addressof(to_bat) || to_bat.closed() || to_bat.full()) {
-				return false;
-			}
-			return to_bat.can_get_from(from_bat);
-		});
-	});
-}
-
-auto puzzle::push_next_moves(const puzzle &state,
-							 const std::vector<move> &moves,
-							 std::deque<std::pair<puzzle, std::vector<move>>> &queue) -> void {
-	const auto n = state.size();
-	for(size_t src = 0; src < n; ++src) {
-		const auto &from = state.at(src);
-		if(from.closed() || from.empty()) {
-			continue;
-		}
-		for(size_t dst = 0; dst < n; ++dst) {
-			if(src == dst) {
-				continue;
-			}
-			const auto &to = state.at(dst);
-			if(to.closed() || to.full()) {
-				continue;
-			}
-			if(!to.can_get_from(from)) {
-				continue;
-			}
-			puzzle next = state;
-			next.at(dst).transfer_energy_from(next.at(src));
-			auto next_moves = moves;
-			next_moves.push_back(move{.from = src, .to = dst});
-			queue.emplace_back(std::move(next), std::move(next_moves));
-		}
-	}
-}
-
 } // namespace energy
@@ -1,4 +1,4 @@
-﻿// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-FileCopyrightText: 2026 Juan Medina
 // SPDX-License-Identifier: MIT
 
 #pragma once
@@ -6,12 +6,17 @@
 #include <pxe/result.hpp>
 
 #include "battery.hpp"
+#include "packed_puzzle.hpp"
+#include "rng.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstddef>
-#include <deque>
+#include <cstdint>
+#include <span>
 #include <string>
-#include <utility>
+#include <type_traits>
 #include <vector>
 
 namespace energy {
@@ -25,44 +30,92 @@ public:
 		std::size_t to;
 	};
 
+	// =============================================================================
+	// Solving strategies, all but depth_first return optimal solutions
+	enum class strategy : std::uint8_t {
+		breadth_first,
+		depth_first,
+		a_star,
+		ida_star,
+		parallel_breadth_first,
+		bidirectional,
+	};
+
 	// =============================================================================
 	// Puzzle solving and identification
 	[[nodiscard]] auto id() const -> std::string;
-	[[nodiscard]] auto solve(bool optimized = true) const -> std::vector<move>;
+	[[nodiscard]] auto pack() const -> packed_puzzle;
+	[[nodiscard]] auto solve(strategy mode = strategy::breadth_first) const -> std::vector<move>;
 
 	// =============================================================================
 	// Puzzle data accessors
 	[[nodiscard]] auto size() const -> size_t {
-		return batteries_.size();
+		return size_;
 	}
 
-	[[nodiscard]] auto at(const size_t index) -> battery & {
-		return batteries_.at(index);
-	}
 	[[nodiscard]] auto at(const size_t index) const -> const battery & {
+		assert(index < size_ && "battery index out of range");
 		return batteries_.at(index);
 	}
 
+	// order-independent Zobrist hash, kept up to date by transfer
+	[[nodiscard]] auto hash() const -> std::uint64_t {
+		return hash_;
+	}
+
+	auto transfer(const move &mv) -> void;
+
 	// =============================================================================
 	// Puzzle creation and analysis
 	[[nodiscard]] static auto from_string(const std::string &str) -> pxe::result<puzzle>;
 	[[nodiscard]] auto to_string() const -> std::string;
-	[[nodiscard]] static auto random(size_t total_energies, size_t free_slots) -> puzzle;
+	// same engine state, same puzzle; safe to call from several threads with one engine each
+	[[nodiscard]] static auto random(size_t total_energies, size_t free_slots, rng &engine) -> puzzle;
+	// solvable by construction, a solved board walked back depth random transfers; more depth, more
+	// scrambled, at a cost that does not depend on how hard the result is to solve
+	[[nodiscard]] static auto scrambled(size_t total_energies, size_t free_slots, size_t depth, rng &engine)
+		-> puzzle;
 
-	[[nodiscard]] auto is_solved() const -> bool;
+	// counters kept by transfer, so these are cheap enough to ask every frame
+	[[nodiscard]] auto is_solved() const -> bool {
+		return closed_ + empty_ == size_;
+	}
 
-	[[nodiscard]] auto is_solvable() const -> bool;
+	[[nodiscard]] auto is_solvable() const -> bool {
+		return legal_moves_ != 0;
+	}
+
+	[[nodiscard]] auto legal_move_count() const -> size_t {
+		return legal_moves_;
+	}
 
 	[[nodiscard]] auto has_any_full_battery() const -> bool {
-		return std::ranges::any_of(batteries_, [](const auto &bat) -> bool { return bat.full(); });
+		return std::ranges::any_of(batteries(), [](const auto &bat) -> bool { return bat.full(); });
 	}
 
-private:
-	std::vector<battery> batteries_;
 	static constexpr auto max_batteries = 12;
-	static auto push_next_moves(const puzzle &state,
-								const std::vector<move> &moves,
-								std::deque<std::pair<puzzle, std::vector<move>>> &queue) -> void;
+
+private:
+	// batteries live inline so a puzzle is a plain value, copied without touching the heap
+	std::array<battery, max_batteries> batteries_{};
+	std::uint8_t size_ = 0;
+	std::uint8_t closed_ = 0;
+	std::uint8_t empty_ = 0;
+	std::uint8_t legal_moves_ = 0;
+	std::uint64_t hash_ = 0;
+	[[nodiscard]] auto batteries() const -> std::span<const battery> {
+		return std::span{batteries_}.first(size_);
+	}
+	auto push_battery(const battery &bat) -> void;
+	[[nodiscard]] static auto choose_types(size_t total_energies, rng &engine) -> std::vector<int>;
+	[[nodiscard]] static auto unpack(packed_puzzle::cell value) -> battery;
+	// adds or removes one battery from the closed and empty counters
+	auto count_battery(const battery &bat, int sign) -> void;
+	// legal transfers either way between two batteries, and every legal transfer with an end in either one
+	[[nodiscard]] auto moves_between(size_t first, size_t second) const -> int;
+	[[nodiscard]] auto moves_touching(size_t first, size_t second) const -> int;
 };
 
+static_assert(std::is_trivially_copyable_v<puzzle>, "puzzle snapshots are copied as raw bytes");
+
 } // namespace energy
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "zobrist.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <ranges>
+
+namespace energy {
+
+// Seedable splitmix64 generator for puzzle generation, a single word of state so it is free to create
+// per candidate or per thread, and the same seed always gives the same sequence on every platform.
+// Standard distributions and std::shuffle may draw from it differently per library, so puzzles use shuffle
+// below and plain modulo draws.
+class rng {
+public:
+	using result_type = std::uint64_t;
+
+	explicit constexpr rng(const std::uint64_t seed = 0): state_{seed} {}
+
+	[[nodiscard]] static constexpr auto min() -> result_type {
+		return 0;
+	}
+	[[nodiscard]] static constexpr auto max() -> result_type {
+		return std::numeric_limits<result_type>::max();
+	}
+
+	constexpr auto operator()() -> result_type {
+		state_ += increment;
+		return zobrist::mix(state_);
+	}
+
+	// seed of an independent stream, so (seed, index) pairs can be split across threads freely
+	[[nodiscard]] static constexpr auto derive(const std::uint64_t seed, const std::uint64_t index) -> std::uint64_t {
+		return zobrist::mix(seed ^ zobrist::mix(index + increment));
+	}
+
+private:
+	static constexpr std::uint64_t increment = 0x9E3779B97F4A7C15ULL;
+	std::uint64_t state_;
+};
+
+// Fisher-Yates with one draw per element, the same order on every standard library
+template<std::ranges::random_access_range Range>
+constexpr auto shuffle(Range &&range, rng &engine) -> void {
+	const auto first = std::ranges::begin(range);
+	for(auto i = std::ranges::distance(range) - 1; i > 0; --i) {
+		const auto j = static_cast<decltype(i)>(engine() % static_cast<std::uint64_t>(i + 1));
+		std::ranges::iter_swap(first + i, first + j);
+	}
+}
+
+} // namespace energy
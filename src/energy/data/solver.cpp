@@ -0,0 +1,617 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "solver.hpp"
+
+#include "packed_puzzle.hpp"
+#include "parallel.hpp"
+#include "rng.hpp"
+#include "transposition_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stop_token>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace energy {
+
+auto solver::breadth_first(const packed_puzzle &start) -> move_list {
+	if(auto known = recall(start); known.has_value()) {
+		return *known;
+	}
+	std::unordered_set<packed_puzzle::key, packed_puzzle::key_hash> visited;
+	visited.insert(key_of(start));
+	node_pool nodes{{.state = start, .parent = 0, .last = {}}};
+
+	// the pool doubles as the queue, nodes are appended in breadth-first order
+	for(std::uint32_t head = 0; head < nodes.size(); ++head) {
+		const auto state = nodes.at(head).state;
+		auto goal = std::optional<std::uint32_t>{};
+		for_each_move(state, nodes.at(head).last, [&](const std::size_t src, const std::size_t dst) -> bool {
+			auto next = state;
+			next.transfer(src, dst);
+			if(!visited.insert(key_of(next)).second) {
+				return true;
+			}
+			nodes.push_back({.state = next, .parent = head, .last = packed_move::from_move(src, dst)});
+			if(next.is_solved()) {
+				goal = static_cast<std::uint32_t>(nodes.size() - 1);
+				return false;
+			}
+			return true;
+		});
+		if(goal.has_value()) {
+			return remember(start, rebuild_path(nodes, *goal));
+		}
+	}
+	return remember_unsolvable(start);
+}
+
+auto solver::depth_first(const packed_puzzle &start, const std::stop_token &stop) -> move_list {
+	if(auto known = recall(start); known.has_value()) {
+		return *known;
+	}
+	std::unordered_set<packed_puzzle::key, packed_puzzle::key_hash> visited;
+	visited.insert(key_of(start));
+	node_pool nodes{{.state = start, .parent = 0, .last = {}}};
+	std::vector<std::uint32_t> stack{0};
+
+	while(!stack.empty() && !stop.stop_requested()) {
+		const auto index = stack.back();
+		stack.pop_back();
+		const auto state = nodes.at(index).state;
+		if(state.is_solved()) {
+			return rebuild_path(nodes, index);
+		}
+		for_each_move(state, nodes.at(index).last, [&](const std::size_t src, const std::size_t dst) -> bool {
+			auto next = state;
+			next.transfer(src, dst);
+			if(visited.insert(key_of(next)).second) {
+				stack.push_back(static_cast<std::uint32_t>(nodes.size()));
+				nodes.push_back({.state = next, .parent = index, .last = packed_move::from_move(src, dst)});
+			}
+			return true;
+		});
+	}
+	return stop.stop_requested() ? move_list{} : remember_unsolvable(start);
+}
+
+auto solver::parallel_breadth_first(const packed_puzzle &start, std::size_t threads) -> move_list {
+	if(threads == 0) {
+		threads = hardware_threads();
+	}
+	if(threads <= 1 || !threads_available) {
+		return breadth_first(start);
+	}
+	if(auto known = recall(start); known.has_value()) {
+		return *known;
+	}
+
+	std::vector<visited_shard> visited(threads * shards_per_thread);
+	(void)insert_visited(visited, key_of(start));
+	node_pool nodes{{.state = start, .parent = 0, .last = {}}};
+	std::vector<node_pool> children(threads);
+	std::atomic<bool> solved{false};
+
+	// nodes of one layer are contiguous in the pool, workers only read it while expanding a layer
+	std::size_t layer_begin = 0;
+	std::size_t layer_end = nodes.size();
+	const auto expand = [&](const std::size_t worker, const std::size_t begin, const std::size_t end) -> void {
+		auto &local = children.at(worker);
+		for(auto i = layer_begin + begin; i < layer_begin + end && !solved.load(std::memory_order_relaxed); ++i) {
+			const auto parent = static_cast<std::uint32_t>(i);
+			const auto state = nodes.at(i).state;
+			for_each_move(state, nodes.at(i).last, [&](const std::size_t src, const std::size_t dst) -> bool {
+				auto next = state;
+				next.transfer(src, dst);
+				if(!insert_visited(visited, key_of(next))) {
+					return true;
+				}
+				local.push_back({.state = next, .parent = parent, .last = packed_move::from_move(src, dst)});
+				if(next.is_solved()) {
+					solved.store(true, std::memory_order_relaxed);
+					return false;
+				}
+				return true;
+			});
+		}
+	};
+
+	// the workers outlive every layer, a search runs dozens of short layers
+	worker_pool pool{threads};
+	while(layer_begin < layer_end) {
+		pool.run(layer_end - layer_begin, expand);
+
+		for(auto &local: children) {
+			for(const auto &child: local) {
+				nodes.push_back(child);
+				if(child.state.is_solved()) {
+					return remember(start, rebuild_path(nodes, static_cast<std::uint32_t>(nodes.size() - 1)));
+				}
+			}
+			local.clear();
+		}
+		layer_begin = layer_end;
+		layer_end = nodes.size();
+	}
+	return remember_unsolvable(start);
+}
+
+auto solver::insert_visited(std::vector<visited_shard> &shards, const packed_puzzle::key &key) -> bool {
+	// the high hash bits pick the shard, the low ones are left for the shard's own buckets
+	auto &shard = shards.at((key.hash >> 40U) % shards.size());
+	const std::scoped_lock lock(shard.mutex);
+	return shard.keys.insert(key).second;
+}
+
+auto solver::bidirectional(const packed_puzzle &start) -> move_list {
+	if(auto known = recall(start); known.has_value()) {
+		return *known;
+	}
+	const auto goal = solved_state(start);
+	if(!goal.has_value()) {
+		return remember_unsolvable(start);
+	}
+
+	search_side forward{.nodes = {{.state = start, .parent = 0, .last = {}}},
+						.seen = {},
+						.layer_begin = 0,
+						.depth = 0};
+	search_side backward{.nodes = {{.state = *goal, .parent = 0, .last = {}}},
+						 .seen = {},
+						 .layer_begin = 0,
+						 .depth = 0};
+	forward.seen.emplace(key_of(start), 0);
+	backward.seen.emplace(key_of(*goal), 0);
+
+	std::optional<meeting> best;
+	while(forward.layer_begin < forward.nodes.size() && backward.layer_begin < backward.nodes.size()) {
+		const auto forward_frontier = forward.nodes.size() - forward.layer_begin;
+		const auto backward_frontier = backward.nodes.size() - backward.layer_begin;
+		if(forward_frontier <= backward_frontier) {
+			expand_layer(forward, backward, false, best);
+		} else {
+			expand_layer(backward, forward, true, best);
+		}
+		if(best.has_value()) {
+			return remember(start, join_paths(forward, backward, *best));
+		}
+	}
+	return remember_unsolvable(start);
+}
+
+auto solver::solved_state(const packed_puzzle &start) -> std::optional<packed_puzzle> {
+	std::array<int, 16> energies{};
+	for(size_t i = 0; i < start.size(); ++i) {
+		const auto value = start.at(i);
+		for(auto slot = 0; slot < packed_puzzle::count(value); ++slot) {
+			++energies.at(static_cast<size_t>(packed_puzzle::energy(value, slot)));
+		}
+	}
+	packed_puzzle result;
+	for(size_t color = 1; color < energies.size(); ++color) {
+		if(energies.at(color) % packed_puzzle::slots != 0) {
+			return std::nullopt;
+		}
+		const auto closed = static_cast<packed_puzzle::cell>(color * 0x1111U);
+		for(auto i = 0; i < energies.at(color) / packed_puzzle::slots; ++i) {
+			result.push_back(closed);
+		}
+	}
+	while(result.size() < start.size()) {
+		result.push_back(0);
+	}
+	return result;
+}
+
+auto solver::depth_of(const node_pool &nodes, std::uint32_t index) -> int {
+	auto depth = 0;
+	for(; index != 0; index = nodes.at(index).parent) {
+		++depth;
+	}
+	return depth;
+}
+
+// expands the whole current layer of one side, so the shortest meeting of that layer can be kept
+auto solver::expand_layer(search_side &side,
+						  const search_side &other,
+						  const bool backward,
+						  std::optional<meeting> &best) -> void {
+	const auto layer_end = side.nodes.size();
+	++side.depth;
+	for(auto index = side.layer_begin; index < layer_end; ++index) {
+		const auto parent = static_cast<std::uint32_t>(index);
+		const auto state = side.nodes.at(index).state;
+		const auto add_child = [&](const packed_puzzle &next, const std::size_t src, const std::size_t dst) -> void {
+			const auto key = key_of(next);
+			if(!side.seen.try_emplace(key, static_cast<std::uint32_t>(side.nodes.size())).second) {
+				return;
+			}
+			const auto child = static_cast<std::uint32_t>(side.nodes.size());
+			side.nodes.push_back({.state = next, .parent = parent, .last = packed_move::from_move(src, dst)});
+			if(const auto found = other.seen.find(key); found != other.seen.end()) {
+				const auto length = side.depth + depth_of(other.nodes, found->second);
+				if(!best.has_value() || length < best->length) {
+					best = backward ? meeting{.forward = found->second, .backward = child, .length = length}
+									: meeting{.forward = child, .backward = found->second, .length = length};
+				}
+			}
+		};
+		if(backward) {
+			for_each_reverse_move(state, [&](const std::size_t src, const std::size_t dst, const int moved) -> bool {
+				auto next = state;
+				next.undo(src, dst, moved);
+				add_child(next, src, dst);
+				return true;
+			});
+		} else {
+			for_each_move(state, side.nodes.at(index).last, [&](const std::size_t src, const std::size_t dst) -> bool {
+				auto next = state;
+				next.transfer(src, dst);
+				add_child(next, src, dst);
+				return true;
+			});
+		}
+	}
+	side.layer_begin = layer_end;
+}
+
+// both halves meet on the same canonical state, but the backward half may hold its batteries in a
+// different order, so its moves are mapped onto the forward battery indices
+auto solver::join_paths(const search_side &forward, const search_side &backward, const meeting &met) -> move_list {
+	auto path = rebuild_path(forward.nodes, met.forward);
+
+	const auto &forward_state = forward.nodes.at(met.forward).state;
+	const auto &backward_state = backward.nodes.at(met.backward).state;
+	const auto forward_colors = relabeling_of(forward_state);
+	const auto backward_colors = relabeling_of(backward_state);
+	std::array<std::size_t, packed_puzzle::max_batteries> to_forward{};
+	std::array<bool, packed_puzzle::max_batteries> used{};
+	for(size_t i = 0; i < backward_state.size(); ++i) {
+		const auto wanted = packed_puzzle::relabel(backward_state.at(i), backward_colors);
+		for(size_t j = 0; j < forward_state.size(); ++j) {
+			if(!used.at(j) && packed_puzzle::relabel(forward_state.at(j), forward_colors) == wanted) {
+				used.at(j) = true;
+				to_forward.at(i) = j;
+				break;
+			}
+		}
+	}
+
+	for(auto index = met.backward; index != 0; index = backward.nodes.at(index).parent) {
+		const auto [from, to] = backward.nodes.at(index).last.to_move();
+		path.push_back({.from = to_forward.at(from), .to = to_forward.at(to)});
+	}
+	return path;
+}
+
+// Every move takes the top run of one battery and either merges it onto the same color, removing one
+// segment from the board, or drops it into an empty battery, keeping the segment count. A solved board has
+// one segment per color, so (segments - colors) moves must merge, and every color that is not at the bottom
+// of any battery still needs at least one move into an empty battery. A move changes this bound by at most
+// one, so it is also consistent. Non-homogeneous batteries and buried runs are both counted as extra segments.
+auto solver::heuristic(const packed_puzzle &state) -> int {
+	auto segments = 0;
+	std::uint16_t colors = 0;
+	std::uint16_t bottoms = 0;
+	for(size_t i = 0; i < state.size(); ++i) {
+		const auto value = state.at(i);
+		const auto total = packed_puzzle::count(value);
+		if(total == 0) {
+			continue;
+		}
+		bottoms |= static_cast<std::uint16_t>(1U << packed_puzzle::energy(value, 0));
+		auto previous = 0;
+		for(auto slot = 0; slot < total; ++slot) {
+			const auto energy = packed_puzzle::energy(value, slot);
+			colors |= static_cast<std::uint16_t>(1U << energy);
+			if(energy != previous) {
+				++segments;
+				previous = energy;
+			}
+		}
+	}
+	const auto distinct = std::popcount(colors);
+	const auto bottomless = std::popcount(static_cast<std::uint16_t>(colors & ~bottoms));
+	return segments - distinct + bottomless;
+}
+
+// depth-first over the reachable states until a solved one turns up, the whole space is seen or the budget
+// runs out; only the last case leaves the answer open
+auto solver::probe_solvable(const packed_puzzle &start, const std::size_t node_budget) -> std::optional<bool> {
+	if(start.is_solved()) {
+		return true;
+	}
+	std::vector<std::pair<packed_puzzle, packed_move>> pending{{start, packed_move{}}};
+	std::unordered_set<packed_puzzle::key, packed_puzzle::key_hash> seen{key_of(start)};
+	auto outcome = std::optional<bool>{false};
+	while(!pending.empty() && outcome == false) {
+		const auto [state, last] = pending.back();
+		pending.pop_back();
+		for_each_move(state, last, [&](const std::size_t src, const std::size_t dst) -> bool {
+			auto next = state;
+			next.transfer(src, dst);
+			if(next.is_solved()) {
+				outcome = true;
+				return false;
+			}
+			if(seen.insert(key_of(next)).second) {
+				if(seen.size() > node_budget) {
+					outcome = std::nullopt;
+					return false;
+				}
+				pending.emplace_back(next, packed_move::from_move(src, dst));
+			}
+			return true;
+		});
+	}
+	// once every reachable state was seen there is no solution, pruning never hides one
+	return outcome;
+}
+
+// reverse transfers are picked uniformly among the ones that do not undo the previous step
+auto solver::scramble(packed_puzzle state, const std::size_t depth, rng &engine) -> packed_puzzle {
+	struct reverse_move {
+		std::size_t from;
+		std::size_t to;
+		int moved;
+	};
+	std::vector<reverse_move> moves;
+	std::optional<reverse_move> last;
+	for(std::size_t step = 0; step < depth; ++step) {
+		moves.clear();
+		for_each_reverse_move(state, [&](const std::size_t src, const std::size_t dst, const int moved) -> bool {
+			if(!last.has_value() || src != last->to || dst != last->from) {
+				moves.push_back({.from = src, .to = dst, .moved = moved});
+			}
+			return true;
+		});
+		if(moves.empty()) {
+			break;
+		}
+		const auto picked = moves.at(static_cast<std::size_t>(engine() % moves.size()));
+		state.undo(picked.from, picked.to, picked.moved);
+		last = picked;
+	}
+	return state;
+}
+
+auto solver::a_star(const packed_puzzle &start, const std::stop_token &stop) -> move_list {
+	if(auto known = recall(start); known.has_value()) {
+		return *known;
+	}
+	struct open_entry {
+		int cost;
+		int depth;
+		std::uint32_t index;
+	};
+	// lowest estimated cost first, deeper nodes first on ties so the goal is reached sooner
+	const auto later = [](const open_entry &lhs, const open_entry &rhs) -> bool {
+		return lhs.cost != rhs.cost ? lhs.cost > rhs.cost : lhs.depth < rhs.depth;
+	};
+	std::priority_queue<open_entry, std::vector<open_entry>, decltype(later)> open(later);
+	std::unordered_map<packed_puzzle::key, int, packed_puzzle::key_hash> best;
+	node_pool nodes;
+
+	nodes.push_back({.state = start, .parent = 0, .last = {}});
+	best.emplace(key_of(start), 0);
+	open.push({.cost = heuristic(start), .depth = 0, .index = 0});
+
+	while(!open.empty() && !stop.stop_requested()) {
+		const auto current = open.top();
+		open.pop();
+		const auto state = nodes.at(current.index).state;
+		if(best.at(key_of(state)) < current.depth) {
+			continue;
+		}
+
+		if(state.is_solved()) {
+			return remember(start, rebuild_path(nodes, current.index));
+		}
+
+		const auto depth = current.depth + 1;
+		for_each_move(state, nodes.at(current.index).last, [&](const std::size_t src, const std::size_t dst) -> bool {
+			auto next = state;
+			next.transfer(src, dst);
+			if(const auto [it, inserted] = best.try_emplace(key_of(next), depth); !inserted) {
+				if(it->second <= depth) {
+					return true;
+				}
+				it->second = depth;
+			}
+			const auto index = static_cast<std::uint32_t>(nodes.size());
+			nodes.push_back({.state = next, .parent = current.index, .last = packed_move::from_move(src, dst)});
+			open.push({.cost = depth + heuristic(next), .depth = depth, .index = index});
+			return true;
+		});
+	}
+	// a cancelled search has not proven anything
+	return stop.stop_requested() ? move_list{} : remember_unsolvable(start);
+}
+
+auto solver::ida_star(const packed_puzzle &start, const std::size_t transposition_entries) -> move_list {
+	assert(std::has_single_bit(transposition_entries) || transposition_entries == 0);
+	if(auto known = recall(start); known.has_value()) {
+		return *known;
+	}
+	ida_star_context context{
+		.state = start,
+		.path = {},
+		.bound = heuristic(start),
+		.iteration = 0,
+		.table = std::vector<transposition_entry>(transposition_entries, transposition_entry{}),
+	};
+	while(context.bound <= max_ida_star_depth) {
+		++context.iteration;
+		const auto next_bound = ida_star_probe(context, 0);
+		if(next_bound == ida_star_found) {
+			return remember(start, context.path);
+		}
+		if(next_bound == std::numeric_limits<int>::max()) {
+			return remember_unsolvable(start);
+		}
+		context.bound = next_bound;
+	}
+	return {};
+}
+
+auto solver::ida_star_probe(ida_star_context &context, const int depth) -> int {
+	if(const auto estimate = depth + heuristic(context.state); estimate > context.bound) {
+		return estimate;
+	}
+	if(context.state.is_solved()) {
+		return ida_star_found;
+	}
+	if(seen_in_iteration(context, depth)) {
+		return std::numeric_limits<int>::max();
+	}
+
+	auto next_bound = std::numeric_limits<int>::max();
+	const auto state = context.state;
+	const auto last = context.path.empty() ? packed_move{}
+										   : packed_move::from_move(context.path.back().from, context.path.back().to);
+	for_each_move(state, last, [&](const std::size_t src, const std::size_t dst) -> bool {
+		const auto moved = context.state.transfer(src, dst);
+		context.path.push_back({.from = src, .to = dst});
+		const auto result = ida_star_probe(context, depth + 1);
+		if(result == ida_star_found) {
+			next_bound = ida_star_found;
+			return false;
+		}
+		context.path.pop_back();
+		context.state.undo(src, dst, moved);
+		next_bound = std::min(next_bound, result);
+		return true;
+	});
+	return next_bound;
+}
+
+// a state already expanded in this iteration at the same or a lower depth cannot lead anywhere new
+auto solver::seen_in_iteration(ida_star_context &context, const int depth) -> bool {
+	if(context.table.empty()) {
+		return false;
+	}
+	const auto hash = context.state.hash();
+	auto &entry = context.table.at(hash & (context.table.size() - 1));
+	if(entry.hash == hash && entry.iteration == context.iteration && entry.depth <= depth) {
+		return true;
+	}
+	entry = {.hash = hash, .depth = static_cast<std::uint16_t>(depth), .iteration = context.iteration};
+	return false;
+}
+
+auto solver::set_color_symmetry(const bool enabled) -> void {
+	// entries recorded under the other key form would not be found, or worse, be misread
+	if(color_symmetry_.exchange(enabled, std::memory_order_relaxed) != enabled) {
+		transposition_table::session().clear();
+	}
+}
+
+auto solver::key_of(const packed_puzzle &state) -> packed_puzzle::key {
+	return color_symmetry() ? state.color_canonical() : state.canonical();
+}
+
+auto solver::relabeling_of(const packed_puzzle &state) -> packed_puzzle::relabeling {
+	if(color_symmetry()) {
+		return state.color_relabeling();
+	}
+	packed_puzzle::relabeling identity{};
+	for(size_t color = 0; color < identity.size(); ++color) {
+		identity.at(color) = static_cast<std::uint8_t>(color);
+	}
+	return identity;
+}
+
+auto solver::recall(const packed_puzzle &start) -> std::optional<move_list> {
+	auto &table = transposition_table::session();
+	move_list path;
+	auto state = start;
+	auto expected = std::size_t{0};
+	while(!state.is_solved()) {
+		const auto known = table.find(key_of(state));
+		if(!known.has_value()) {
+			return std::nullopt;
+		}
+		if(known->unsolvable) {
+			return move_list{};
+		}
+		// each step must be one move closer to the goal than the one before
+		if(!path.empty() && known->distance + path.size() != expected) {
+			return std::nullopt;
+		}
+		expected = known->distance + path.size();
+		// any batteries with the recorded contents will do, they are interchangeable
+		const auto next = find_move(state, relabeling_of(state), known->from, known->to);
+		if(!next.has_value()) {
+			return std::nullopt;
+		}
+		state.transfer(next->from, next->to);
+		path.push_back(*next);
+	}
+	return path;
+}
+
+auto solver::find_move(const packed_puzzle &state,
+					   const packed_puzzle::relabeling &colors,
+					   const packed_puzzle::cell from,
+					   const packed_puzzle::cell to) -> std::optional<move> {
+	for(size_t src = 0; src < state.size(); ++src) {
+		if(packed_puzzle::relabel(state.at(src), colors) != from) {
+			continue;
+		}
+		for(size_t dst = 0; dst < state.size(); ++dst) {
+			if(src != dst && packed_puzzle::relabel(state.at(dst), colors) == to && state.can_transfer(src, dst)) {
+				return move{.from = src, .to = dst};
+			}
+		}
+	}
+	return std::nullopt;
+}
+
+auto solver::remember(const packed_puzzle &start, const move_list &path) -> move_list {
+	auto &table = transposition_table::session();
+	auto state = start;
+	for(size_t step = 0; step < path.size(); ++step) {
+		const auto [from, to] = path.at(step);
+		const auto colors = relabeling_of(state);
+		table.store(key_of(state),
+					{
+						.distance = static_cast<std::uint8_t>(path.size() - step),
+						.from = packed_puzzle::relabel(state.at(from), colors),
+						.to = packed_puzzle::relabel(state.at(to), colors),
+						.unsolvable = false,
+					});
+		state.transfer(from, to);
+	}
+	return path;
+}
+
+auto solver::remember_unsolvable(const packed_puzzle &start) -> move_list {
+	transposition_table::session().store(key_of(start), {.distance = 0, .from = 0, .to = 0, .unsolvable = true});
+	return {};
+}
+
+auto solver::rebuild_path(const node_pool &nodes, std::uint32_t index) -> move_list {
+	move_list path;
+	while(index != 0) {
+		const auto &current = nodes.at(index);
+		path.push_back(current.last.to_move());
+		index = current.parent;
+	}
+	std::ranges::reverse(path);
+	return path;
+}
+
+} // namespace energy
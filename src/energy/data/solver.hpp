@@ -0,0 +1,240 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "packed_puzzle.hpp"
+#include "puzzle.hpp"
+#include "rng.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace energy {
+
+class solver {
+public:
+	using move = puzzle::move;
+	using move_list = std::vector<move>;
+
+	// =============================================================================
+	// Search strategies
+	[[nodiscard]] static auto breadth_first(const packed_puzzle &start) -> move_list;
+
+	// a stop request makes these give up and return an empty list
+	[[nodiscard]] static auto depth_first(const packed_puzzle &start, const std::stop_token &stop = {}) -> move_list;
+	[[nodiscard]] static auto a_star(const packed_puzzle &start, const std::stop_token &stop = {}) -> move_list;
+
+	// level-synchronous breadth-first search, each layer is expanded across threads (zero uses every
+	// hardware thread) against a sharded visited set; returns the same move count as breadth_first
+	[[nodiscard]] static auto parallel_breadth_first(const packed_puzzle &start, std::size_t threads = 0) -> move_list;
+
+	// breadth-first from both ends, forward from start and backward through reverse transfers from the
+	// solved state, which is unique once battery order is ignored; optimal like breadth_first
+	[[nodiscard]] static auto bidirectional(const packed_puzzle &start) -> move_list;
+
+	// iterative deepening A*, memory is linear in the solution depth plus an optional fixed-size
+	// transposition table (zero entries disables it); it gives up past max_ida_star_depth
+	static constexpr std::size_t default_transposition_entries = 1U << 13U;
+	static constexpr auto max_ida_star_depth = 96;
+	[[nodiscard]] static auto ida_star(const packed_puzzle &start,
+									   std::size_t transposition_entries = default_transposition_entries) -> move_list;
+
+	// =============================================================================
+	// Bounded depth-first probe for generators: whether start can be solved, when the answer turns up
+	// within node_budget states, and nothing when the search would need more
+	static constexpr std::size_t default_probe_budget = 256;
+	[[nodiscard]] static auto probe_solvable(const packed_puzzle &start, std::size_t node_budget = default_probe_budget)
+		-> std::optional<bool>;
+
+	// =============================================================================
+	// Walks depth random reverse transfers back from state, never straight back over the previous one;
+	// every state reached can be played forward to state, so starting from a solved board the result is
+	// solvable without a search. It stops early on a state no transfer can lead to
+	[[nodiscard]] static auto scramble(packed_puzzle state, std::size_t depth, rng &engine) -> packed_puzzle;
+
+	// =============================================================================
+	// Admissible and consistent lower bound on the number of moves left
+	[[nodiscard]] static auto heuristic(const packed_puzzle &state) -> int;
+
+	// =============================================================================
+	// Color symmetry in state keys, off by default; it clears the session table when it changes
+	static auto set_color_symmetry(bool enabled) -> void;
+	[[nodiscard]] static auto color_symmetry() -> bool {
+		return color_symmetry_.load(std::memory_order_relaxed);
+	}
+
+	// =============================================================================
+	// Nodes expanded by every strategy since the last reset, for the benchmarks
+	[[nodiscard]] static auto expanded_nodes() -> std::uint64_t {
+		return expanded_nodes_.load(std::memory_order_relaxed);
+	}
+	static auto reset_expanded_nodes() -> void {
+		expanded_nodes_.store(0, std::memory_order_relaxed);
+	}
+
+	// =============================================================================
+	// Symmetry and dominance pruning of successors, on by default, every strategy keeps its solution
+	// length with it either way
+	static auto set_move_pruning(const bool enabled) -> void {
+		move_pruning_.store(enabled, std::memory_order_relaxed);
+	}
+	[[nodiscard]] static auto move_pruning() -> bool {
+		return move_pruning_.load(std::memory_order_relaxed);
+	}
+
+private:
+	// =============================================================================
+	// Session transposition table, every strategy first replays what is already known about the start
+	// and optimal strategies record each state of the path they find; proven dead ends are recorded too
+	[[nodiscard]] static auto recall(const packed_puzzle &start) -> std::optional<move_list>;
+	static auto remember(const packed_puzzle &start, const move_list &path) -> move_list;
+	static auto remember_unsolvable(const packed_puzzle &start) -> move_list;
+	[[nodiscard]] static auto find_move(const packed_puzzle &state,
+										const packed_puzzle::relabeling &colors,
+										packed_puzzle::cell from,
+										packed_puzzle::cell to) -> std::optional<move>;
+
+	// the key visited sets and caches use, and the relabeling the stored battery contents are in
+	[[nodiscard]] static auto key_of(const packed_puzzle &state) -> packed_puzzle::key;
+	[[nodiscard]] static auto relabeling_of(const packed_puzzle &state) -> packed_puzzle::relabeling;
+
+	// =============================================================================
+	// Node pool, each node points to its parent and keeps the move that reached it in one byte,
+	// the solution path is only rebuilt once the goal is found
+	struct packed_move {
+		std::uint8_t value{0};
+
+		[[nodiscard]] static constexpr auto from_move(const std::size_t from, const std::size_t to) -> packed_move {
+			return {.value = static_cast<std::uint8_t>((from << 4U) | to)};
+		}
+		[[nodiscard]] constexpr auto to_move() const -> move {
+			return {.from = static_cast<std::size_t>(value >> 4U), .to = static_cast<std::size_t>(value & 0xFU)};
+		}
+	};
+
+	struct node {
+		packed_puzzle state;
+		std::uint32_t parent;
+		packed_move last;
+	};
+	using node_pool = std::vector<node>;
+	[[nodiscard]] static auto rebuild_path(const node_pool &nodes, std::uint32_t index) -> move_list;
+
+	struct search_side {
+		node_pool nodes;
+		std::unordered_map<packed_puzzle::key, std::uint32_t, packed_puzzle::key_hash> seen;
+		std::size_t layer_begin{0};
+		int depth{0};
+	};
+	struct meeting {
+		std::uint32_t forward;
+		std::uint32_t backward;
+		int length;
+	};
+	[[nodiscard]] static auto solved_state(const packed_puzzle &start) -> std::optional<packed_puzzle>;
+	[[nodiscard]] static auto depth_of(const node_pool &nodes, std::uint32_t index) -> int;
+	static auto expand_layer(search_side &side, const search_side &other, bool backward, std::optional<meeting> &best)
+		-> void;
+	[[nodiscard]] static auto join_paths(const search_side &forward, const search_side &backward, const meeting &met)
+		-> move_list;
+
+	struct visited_shard {
+		std::mutex mutex;
+		std::unordered_set<packed_puzzle::key, packed_puzzle::key_hash> keys;
+	};
+	static constexpr auto shards_per_thread = 8;
+	[[nodiscard]] static auto insert_visited(std::vector<visited_shard> &shards, const packed_puzzle::key &key) -> bool;
+
+	// calls visit(from, to, moved) for every forward move of `moved` energies that would lead to state
+	template<typename Visitor>
+	static auto for_each_reverse_move(const packed_puzzle &state, Visitor &&visit) -> void {
+		expanded_nodes_.fetch_add(1, std::memory_order_relaxed);
+		const auto n = state.size();
+		for(std::size_t dst = 0; dst < n; ++dst) {
+			const auto target = state.at(dst);
+			const auto color = packed_puzzle::top(target);
+			const auto run = packed_puzzle::run(target);
+			const auto total = packed_puzzle::count(target);
+			// the energies left behind must be empty or topped by the same color
+			for(auto moved = 1; moved <= run && (moved < run || run == total); ++moved) {
+				for(std::size_t src = 0; src < n; ++src) {
+					const auto source = state.at(src);
+					// the source must have held exactly this run, and not as a closed battery
+					if(src == dst || (source != 0 && packed_puzzle::top(source) == color)
+					   || packed_puzzle::count(source) + moved > packed_puzzle::slots
+					   || (source == 0 && moved == packed_puzzle::slots)) {
+						continue;
+					}
+					if(!visit(src, dst, moved)) {
+						return;
+					}
+				}
+			}
+		}
+	}
+
+	// calls visit(from, to) for every legal move until it returns false, last is the move that reached
+	// state; with pruning on it skips moves whose result is only a battery permutation of a state one
+	// move closer to the start, which never shortens a solution
+	template<typename Visitor>
+	static auto for_each_move(const packed_puzzle &state, const packed_move last, Visitor &&visit) -> void {
+		expanded_nodes_.fetch_add(1, std::memory_order_relaxed);
+		const auto prune = move_pruning();
+		const auto [last_from, last_to] = last.to_move();
+		const auto moves = state.legal_moves();
+		for(std::size_t src = 0; src < state.size(); ++src) {
+			const auto source = state.at(src);
+			// a homogeneous battery moved into an empty one just swaps the two
+			const auto homogeneous = packed_puzzle::run(source) == packed_puzzle::count(source);
+			auto tried_empty = false;
+			for(auto targets = moves.at(src); targets != 0;
+				targets &= static_cast<packed_puzzle::move_mask>(targets - 1U)) {
+				const auto dst = static_cast<std::size_t>(std::countr_zero(targets));
+				if(prune) {
+					const auto target_empty = state.at(dst) == 0;
+					// empty batteries are interchangeable, and moving right back is dominated by one
+					// direct move from the previous state
+					if((target_empty && (tried_empty || homogeneous)) || (src == last_to && dst == last_from)) {
+						continue;
+					}
+					tried_empty = tried_empty || target_empty;
+				}
+				if(!visit(src, dst)) {
+					return;
+				}
+			}
+		}
+	}
+
+	static inline std::atomic<bool> move_pruning_{true};
+	static inline std::atomic<bool> color_symmetry_{false};
+	static inline std::atomic<std::uint64_t> expanded_nodes_{0};
+
+	struct transposition_entry {
+		std::uint64_t hash;
+		std::uint16_t depth;
+		std::uint16_t iteration;
+	};
+
+	struct ida_star_context {
+		packed_puzzle state;
+		move_list path;
+		int bound{0};
+		std::uint16_t iteration{0};
+		std::vector<transposition_entry> table;
+	};
+	static constexpr auto ida_star_found = -1;
+	[[nodiscard]] static auto ida_star_probe(ida_star_context &context, int depth) -> int;
+	[[nodiscard]] static auto seen_in_iteration(ida_star_context &context, int depth) -> bool;
+};
+
+} // namespace energy
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "transposition_table.hpp"
+
+#include "packed_puzzle.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+
+namespace energy {
+
+transposition_table::transposition_table(const std::size_t capacity): capacity_{capacity} {
+	assert(capacity > 0 && "Transposition table needs at least one slot");
+	slots_.reserve(capacity);
+	index_.reserve(capacity);
+}
+
+auto transposition_table::session() -> transposition_table & {
+	static transposition_table table;
+	return table;
+}
+
+auto transposition_table::find(const packed_puzzle::key &key) -> std::optional<entry> {
+	if(!is_enabled()) {
+		return std::nullopt;
+	}
+	const std::scoped_lock lock(mutex_);
+	const auto found = index_.find(key);
+	if(found == index_.end()) {
+		misses_.fetch_add(1, std::memory_order_relaxed);
+		return std::nullopt;
+	}
+	hits_.fetch_add(1, std::memory_order_relaxed);
+	auto &current = slots_.at(found->second);
+	current.referenced = true;
+	return current.value;
+}
+
+auto transposition_table::store(const packed_puzzle::key &key, const entry &value) -> void {
+	if(!is_enabled()) {
+		return;
+	}
+	const std::scoped_lock lock(mutex_);
+	if(const auto found = index_.find(key); found != index_.end()) {
+		auto &current = slots_.at(found->second);
+		current.value = value;
+		current.referenced = true;
+		return;
+	}
+	auto position = slots_.size();
+	if(position < capacity_) {
+		slots_.push_back({.key = key, .value = value, .referenced = false});
+	} else {
+		position = evict();
+		index_.erase(slots_.at(position).key);
+		slots_.at(position) = {.key = key, .value = value, .referenced = false};
+	}
+	index_.emplace(key, position);
+}
+
+auto transposition_table::evict() -> std::size_t {
+	while(slots_.at(hand_).referenced) {
+		slots_.at(hand_).referenced = false;
+		hand_ = (hand_ + 1) % slots_.size();
+	}
+	const auto victim = hand_;
+	hand_ = (hand_ + 1) % slots_.size();
+	return victim;
+}
+
+auto transposition_table::clear() -> void {
+	const std::scoped_lock lock(mutex_);
+	slots_.clear();
+	index_.clear();
+	hand_ = 0;
+	hits_.store(0, std::memory_order_relaxed);
+	misses_.store(0, std::memory_order_relaxed);
+}
+
+auto transposition_table::size() const -> std::size_t {
+	const std::scoped_lock lock(mutex_);
+	return slots_.size();
+}
+
+} // namespace energy
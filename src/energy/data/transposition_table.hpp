@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "packed_puzzle.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace energy {
+
+// Bounded table of facts proven about puzzle states, shared by every solve in the session and evicted
+// with the clock algorithm. States are keyed on their canonical form, so the best move is kept as the
+// contents of its source and target batteries rather than their indices.
+class transposition_table {
+public:
+	struct entry {
+		std::uint8_t distance{0};
+		packed_puzzle::cell from{0};
+		packed_puzzle::cell to{0};
+		bool unsolvable{false};
+	};
+
+	static constexpr std::size_t default_capacity = 1U << 15U;
+
+	explicit transposition_table(std::size_t capacity = default_capacity);
+
+	// the table every solver consults for the lifetime of the game
+	[[nodiscard]] static auto session() -> transposition_table &;
+
+	// =============================================================================
+	// Lookup and store, both are thread safe
+	[[nodiscard]] auto find(const packed_puzzle::key &key) -> std::optional<entry>;
+	auto store(const packed_puzzle::key &key, const entry &value) -> void;
+	auto clear() -> void;
+
+	// =============================================================================
+	// Switch and counters
+	auto set_enabled(const bool enabled) -> void {
+		enabled_.store(enabled, std::memory_order_relaxed);
+	}
+	[[nodiscard]] auto is_enabled() const -> bool {
+		return enabled_.load(std::memory_order_relaxed);
+	}
+	[[nodiscard]] auto hits() const -> std::size_t {
+		return hits_.load(std::memory_order_relaxed);
+	}
+	[[nodiscard]] auto misses() const -> std::size_t {
+		return misses_.load(std::memory_order_relaxed);
+	}
+	[[nodiscard]] auto size() const -> std::size_t;
+	[[nodiscard]] auto capacity() const -> std::size_t {
+		return capacity_;
+	}
+
+private:
+	struct slot {
+		packed_puzzle::key key;
+		entry value;
+		bool referenced{false};
+	};
+
+	// picks a slot to reuse, skipping and clearing recently referenced ones
+	[[nodiscard]] auto evict() -> std::size_t;
+
+	mutable std::mutex mutex_;
+	std::size_t capacity_;
+	std::vector<slot> slots_;
+	std::unordered_map<packed_puzzle::key, std::size_t, packed_puzzle::key_hash> index_;
+	std::size_t hand_{0};
+	std::atomic<bool> enabled_{true};
+	std::atomic<std::size_t> hits_{0};
+	std::atomic<std::size_t> misses_{0};
+};
+
+} // namespace energy
@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace energy::zobrist {
+
+static constexpr auto slots = 4;
+static constexpr auto energy_types = 16;
+
+[[nodiscard]] constexpr auto mix(std::uint64_t value) -> std::uint64_t {
+	value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31U);
+}
+
+// one random key per (slot, energy type), a battery hash is the xor of the keys of its energies
+inline constexpr auto keys = []() -> std::array<std::uint64_t, slots * energy_types> {
+	std::array<std::uint64_t, slots * energy_types> result{};
+	std::uint64_t state = 0x5EED'E4E7'65A7'B00FULL;
+	for(auto &key: result) {
+		state += 0x9E3779B97F4A7C15ULL;
+		key = mix(state);
+	}
+	return result;
+}();
+
+[[nodiscard]] constexpr auto key(const std::size_t slot, const int energy) -> std::uint64_t {
+	return keys.at((slot * energy_types) + static_cast<std::size_t>(energy));
+}
+
+// batteries are combined by addition of their mixed hashes, so the puzzle hash does not depend on battery order
+[[nodiscard]] constexpr auto combine(const std::uint64_t battery_hash) -> std::uint64_t {
+	return mix(battery_hash);
+}
+
+} // namespace energy::zobrist
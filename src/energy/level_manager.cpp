@@ -5,12 +5,26 @@
 
 #include <pxe/result.hpp>
 
+#include "data/cosmic_corpus.hpp"
+#include "data/cosmic_pool.hpp"
+#include "data/mapped_file.hpp"
+#include "data/packed_puzzle.hpp"
+#include "data/parallel.hpp"
 #include "data/puzzle.hpp"
+#include "data/rng.hpp"
+#include "data/solver.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <format>
 #include <fstream>
+#include <ios>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stop_token>
 #include <jsoncons/basic_json.hpp>
 #include <jsoncons/json_decoder.hpp>
 #include <jsoncons/json_reader.hpp>
@@ -18,15 +32,79 @@
 #include <sstream>
 #include <string>
 #include <system_error>
+#include <utility>
+#include <vector>
 
 namespace energy {
 
+namespace {
+
+// level pack layout, in the byte order of the machine that wrote it: header, classic records, cosmic
+// difficulties, then their ranges; a pack from a machine of the other order fails the version check
+constexpr std::array<char, 4> pack_magic{'E', 'S', 'L', 'P'};
+constexpr std::uint32_t pack_version = 2;
+
+struct pack_header {
+	std::array<char, 4> magic;
+	std::uint32_t version;
+	std::uint32_t classic;
+	std::uint32_t cosmic;
+	std::uint32_t ranges;
+	std::uint32_t reserved;
+	// level_sources_hash of the json files the pack was built from
+	std::uint64_t sources;
+};
+
+// zero moves when the level has no recorded solution length
+struct pack_classic {
+	std::array<packed_puzzle::cell, packed_puzzle::max_batteries> cells;
+	std::uint8_t batteries;
+	std::uint8_t reserved;
+	std::uint16_t moves;
+};
+
+struct pack_cosmic {
+	std::uint8_t difficulty;
+	std::uint8_t reserved;
+	std::uint16_t padding;
+	std::uint32_t game_time;
+	std::uint32_t battery_time;
+	std::uint32_t first;
+	std::uint32_t count;
+};
+
+struct pack_range {
+	std::uint32_t from;
+	std::uint32_t to;
+	std::uint8_t energies;
+	std::uint8_t empty;
+	std::uint16_t scramble;
+	std::uint16_t min_moves;
+	std::uint16_t max_moves;
+	std::uint32_t budget;
+};
+
+template<typename T>
+auto fits(const size_t value) -> bool {
+	return value <= std::numeric_limits<T>::max();
+}
+
+// 64-bit FNV-1a
+constexpr std::uint64_t fnv_offset = 0xCBF2'9CE4'8422'2325ULL;
+constexpr std::uint64_t fnv_prime = 0x0000'0100'0000'01B3ULL;
+
+} // namespace
+
 auto level_manager::load_levels() -> pxe::result<> {
-	if(const auto err = load_classic_levels(classic_levels_path).unwrap(); err) {
-		return pxe::error("failed to load classic levels", *err);
+	if(const auto err = load_level_pack(level_pack_path).unwrap(); err) {
+		SPDLOG_WARN("level pack not usable, loading the json levels");
+		if(const auto json_err = load_json_levels().unwrap(); json_err) {
+			return pxe::error("failed to load json levels", *json_err);
+		}
 	}
-	if(const auto err = load_cosmic_levels(cosmic_levels_path).unwrap(); err) {
-		return pxe::error("failed to load cosmic levels", *err);
+	// the corpus is optional, ranges it does not cover are generated live
+	if(const auto err = corpus_.open(cosmic_corpus_path).unwrap(); err) {
+		SPDLOG_WARN("cosmic corpus not available, generating cosmic levels live");
 	}
 	return true;
 }
@@ -38,17 +116,19 @@ auto level_manager::get_current_level_string() -> pxe::result<std::string> {
 	last_level_string_ = current_level_;
 	cached_level_string_.clear();
 	if(current_mode_ == mode::cosmic) {
-		for(const auto &[difficult, ranges, game_time, battery_time]: cosmic_levels_) {
-			if(difficult == current_difficulty_) {
-				for(const auto &[from, to, energies, empty]: ranges) {
-					if(current_level_ >= from && current_level_ <= to) {
-						cached_level_string_ = generate_cosmic_level_string(energies, empty);
-					}
-				}
+		if(const auto range = find_cosmic_range(current_difficulty_, current_level_); range.has_value()) {
+			// a ready puzzle when the producer kept up, otherwise draw or generate it here
+			if(auto ready = cosmic_pool_.take(pool_level(current_level_, *range)); ready.has_value()) {
+				cached_level_string_ = std::move(*ready);
+			} else if(const auto err = get_cosmic_level_string(current_difficulty_, current_level_, cosmic_seed_)
+										   .unwrap(cached_level_string_);
+					  err) {
+				return pxe::error("failed to get cosmic level", *err);
 			}
+			prepare_cosmic_pool(current_level_ + 1);
 		}
 	} else {
-		cached_level_string_ = classic_levels_.at(current_level_ - 1);
+		cached_level_string_ = classic_levels_.at(current_level_ - 1).puzzle;
 	}
 
 	if(cached_level_string_.empty()) {
@@ -70,17 +150,88 @@ auto level_manager::get_battery_time() const -> size_t {
 	return get_cosmic_data().battery_time;
 }
 
-auto level_manager::generate_cosmic_level_string(const size_t energies, const size_t empty) -> std::string {
-	while(true) {
-		const auto new_puzzle = puzzle::random(energies, empty);			   // generate a random puzzle
-		if(const auto solution = new_puzzle.solve(false); !solution.empty()) { // ensure the puzzle is solvable
-			return new_puzzle.to_string();
+auto level_manager::generate_cosmic_level_string(const size_t energies, const size_t empty, rng &engine)
+	-> std::string {
+	return random_solvable_puzzle(energies, empty, engine).to_string();
+}
+
+// each candidate goes through the cheapest check that can settle it: boards without a legal move (solved ones
+// included) are dropped in O(n), small reachable spaces are settled by a bounded probe, and only the rest pay
+// for a full search; the engine is only drawn by puzzle::random, so the puzzle picked does not change; a stop
+// request gives an empty puzzle
+auto level_manager::random_solvable_puzzle(const size_t energies,
+										   const size_t empty,
+										   rng &engine,
+										   const std::stop_token &stop) -> puzzle {
+	auto &counters = filter_counters_;
+	while(!stop.stop_requested()) {
+		const auto new_puzzle = puzzle::random(energies, empty, engine);
+		++counters.candidates;
+		if(!new_puzzle.is_solvable()) {
+			++counters.structural_rejects;
+			continue;
+		}
+		if(const auto probed = solver::probe_solvable(new_puzzle.pack()); probed.has_value()) {
+			if(*probed) {
+				++counters.probe_accepts;
+				return new_puzzle;
+			}
+			++counters.probe_rejects;
+			continue;
 		}
+		if(const auto solution = solver::depth_first(new_puzzle.pack(), stop); !solution.empty()) {
+			++counters.search_accepts;
+			return new_puzzle;
+		}
+		if(!stop.stop_requested()) {
+			++counters.search_rejects;
+		}
+	}
+	return {};
+}
+
+auto level_manager::get_filter_stats() -> filter_stats {
+	const auto &counters = filter_counters_;
+	return {.candidates = counters.candidates.load(),
+			.structural_rejects = counters.structural_rejects.load(),
+			.probe_rejects = counters.probe_rejects.load(),
+			.probe_accepts = counters.probe_accepts.load(),
+			.search_rejects = counters.search_rejects.load(),
+			.search_accepts = counters.search_accepts.load()};
+}
+
+auto level_manager::reset_filter_stats() -> void {
+	auto &counters = filter_counters_;
+	for(auto *counter: {&counters.candidates,
+						&counters.structural_rejects,
+						&counters.probe_rejects,
+						&counters.probe_accepts,
+						&counters.search_rejects,
+						&counters.search_accepts}) {
+		counter->store(0);
+	}
+}
+
+auto level_manager::load_json_levels() -> pxe::result<> {
+	if(const auto err = load_classic_levels(classic_levels_path).unwrap(); err) {
+		return pxe::error("failed to load classic levels", *err);
 	}
+	if(const auto err = load_cosmic_levels(cosmic_levels_path).unwrap(); err) {
+		return pxe::error("failed to load cosmic levels", *err);
+	}
+	return true;
 }
 
 auto level_manager::load_classic_levels(const std::string &levels_path) -> pxe::result<> {
 	classic_levels_.clear();
+	if(const auto err = read_classic_levels(levels_path).unwrap(classic_levels_); err) {
+		return pxe::error("failed to read classic levels", *err);
+	}
+	SPDLOG_DEBUG("loaded {} levels from {} (json)", classic_levels_.size(), levels_path);
+	return true;
+}
+
+auto level_manager::read_classic_levels(const std::string &levels_path) -> pxe::result<std::vector<classic_level>> {
 	std::ifstream const file(levels_path);
 	if(!file.is_open()) {
 		return pxe::error(std::format("failed to open levels json file: {}", levels_path));
@@ -98,19 +249,26 @@ auto level_manager::load_classic_levels(const std::string &levels_path) -> pxe::
 	if(!parsed.is_array()) {
 		return pxe::error("levels.json root is not an array");
 	}
+	std::vector<classic_level> levels;
 	for(const auto &level: parsed.array_range()) {
 		if(!level.contains("puzzle")
 		   || !level["puzzle"].is_string()) { // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
 			return pxe::error("level entry missing 'puzzle' string");
 		}
-		classic_levels_.emplace_back(
-			level["puzzle"].as<std::string>()); // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+		classic_level entry{
+			.puzzle = level["puzzle"].as<std::string>(), // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+			.moves = std::nullopt,
+		};
+		if(level.contains("moves")
+		   && level["moves"].is_int64()) { // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+			entry.moves = level["moves"].as<size_t>(); // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+		}
+		levels.push_back(std::move(entry));
 	}
-	if(classic_levels_.empty()) {
+	if(levels.empty()) {
 		return pxe::error(std::format("no levels found in file {}", levels_path));
 	}
-	SPDLOG_DEBUG("loaded {} levels from {} (json)", classic_levels_.size(), levels_path);
-	return true;
+	return levels;
 }
 
 auto level_manager::load_cosmic_levels(const std::string &levels_path) -> pxe::result<> {
@@ -146,6 +304,175 @@ auto level_manager::load_cosmic_levels(const std::string &levels_path) -> pxe::r
 	return true;
 }
 
+// hashes the content, not the modification time, which checkouts and packaging do not keep; carriage returns
+// are skipped so a checkout with windows line endings matches too. Nothing when either file is missing
+auto level_manager::level_sources_hash() -> std::optional<std::uint64_t> {
+	auto result = fnv_offset;
+	for(const auto *source: {classic_levels_path, cosmic_levels_path}) {
+		mapped_file file;
+		if(const auto err = file.open(source).unwrap(); err) {
+			return std::nullopt;
+		}
+		for(const auto value: file.bytes()) {
+			if(value != std::byte{'\r'}) {
+				result = (result ^ std::to_integer<std::uint64_t>(value)) * fnv_prime;
+			}
+		}
+		// the boundary between the files is part of the hash
+		result = (result ^ 0xFFU) * fnv_prime;
+	}
+	return result;
+}
+
+auto level_manager::load_level_pack(const std::string &path) -> pxe::result<> {
+	mapped_file file;
+	if(const auto err = file.open(path).unwrap(); err) {
+		return pxe::error(std::format("failed to open level pack: {}", path), *err);
+	}
+	const auto size = file.bytes().size();
+	if(size < sizeof(pack_header)) {
+		return pxe::error("level pack is too small for its header");
+	}
+	const auto header = file.read<pack_header>(0);
+	if(header.magic != pack_magic || header.version != pack_version) {
+		return pxe::error("level pack has an unknown format");
+	}
+	if(const auto sources = level_sources_hash(); sources.has_value() && *sources != header.sources) {
+		SPDLOG_WARN("level pack was built from other json levels, run energy-swap-pack to rebuild it");
+		return pxe::error("level pack is stale");
+	}
+	const auto cosmic_offset = sizeof(pack_header) + (std::size_t{header.classic} * sizeof(pack_classic));
+	const auto range_offset = cosmic_offset + (std::size_t{header.cosmic} * sizeof(pack_cosmic));
+	if(size < range_offset + (std::size_t{header.ranges} * sizeof(pack_range))) {
+		return pxe::error("level pack is truncated");
+	}
+	if(header.classic == 0 || header.cosmic == 0) {
+		return pxe::error("level pack has no levels");
+	}
+
+	std::vector<classic_level> classic;
+	classic.reserve(header.classic);
+	for(std::size_t i = 0; i < header.classic; ++i) {
+		const auto record = file.read<pack_classic>(sizeof(pack_header) + (i * sizeof(pack_classic)));
+		packed_puzzle packed;
+		for(std::size_t battery = 0; battery < record.batteries && battery < record.cells.size(); ++battery) {
+			packed.push_back(record.cells.at(battery));
+		}
+		classic.push_back({.puzzle = packed.to_string(),
+						   .moves = record.moves != 0 ? std::optional<size_t>{record.moves} : std::nullopt});
+	}
+
+	std::vector<cosmic_level> cosmic;
+	cosmic.reserve(header.cosmic);
+	for(std::size_t i = 0; i < header.cosmic; ++i) {
+		const auto entry = file.read<pack_cosmic>(cosmic_offset + (i * sizeof(pack_cosmic)));
+		if(entry.difficulty > static_cast<std::uint8_t>(difficulty::burger_daddy)
+		   || std::size_t{entry.first} + entry.count > header.ranges) {
+			return pxe::error("level pack has an invalid cosmic level");
+		}
+		cosmic_level level{.difficult = static_cast<difficulty>(entry.difficulty),
+						   .ranges = {},
+						   .game_time = entry.game_time,
+						   .battery_time = entry.battery_time};
+		for(std::size_t index = entry.first; index < std::size_t{entry.first} + entry.count; ++index) {
+			const auto range = file.read<pack_range>(range_offset + (index * sizeof(pack_range)));
+			level.ranges.push_back({.from = range.from,
+									.to = range.to,
+									.energies = range.energies,
+									.empty = range.empty,
+									.scramble = range.scramble,
+									.min_moves = range.min_moves,
+									.max_moves = range.max_moves,
+									.budget = range.budget});
+		}
+		cosmic.push_back(std::move(level));
+	}
+
+	classic_levels_ = std::move(classic);
+	cosmic_levels_ = std::move(cosmic);
+	SPDLOG_DEBUG(
+		"loaded {} levels and {} cosmic levels from {} (pack)", classic_levels_.size(), cosmic_levels_.size(), path);
+	return true;
+}
+
+auto level_manager::write_level_pack(const std::string &path) const -> pxe::result<> {
+	std::vector<pack_classic> classic;
+	for(const auto &[text, moves]: classic_levels_) {
+		puzzle parsed;
+		if(const auto err = puzzle::from_string(text).unwrap(parsed); err) {
+			return pxe::error(std::format("invalid level puzzle: {}", text), *err);
+		}
+		if(!fits<std::uint16_t>(moves.value_or(0))) {
+			return pxe::error(std::format("level moves do not fit the level pack: {}", text));
+		}
+		const auto packed = parsed.pack();
+		pack_classic record{.cells = {},
+							.batteries = static_cast<std::uint8_t>(packed.size()),
+							.reserved = 0,
+							.moves = static_cast<std::uint16_t>(moves.value_or(0))};
+		for(std::size_t i = 0; i < packed.size(); ++i) {
+			record.cells.at(i) = packed.at(i);
+		}
+		classic.push_back(record);
+	}
+
+	std::vector<pack_cosmic> cosmic;
+	std::vector<pack_range> ranges;
+	for(const auto &level: cosmic_levels_) {
+		if(!fits<std::uint32_t>(level.game_time) || !fits<std::uint32_t>(level.battery_time)) {
+			return pxe::error("cosmic level times do not fit the level pack");
+		}
+		cosmic.push_back({.difficulty = static_cast<std::uint8_t>(level.difficult),
+						  .reserved = 0,
+						  .padding = 0,
+						  .game_time = static_cast<std::uint32_t>(level.game_time),
+						  .battery_time = static_cast<std::uint32_t>(level.battery_time),
+						  .first = static_cast<std::uint32_t>(ranges.size()),
+						  .count = static_cast<std::uint32_t>(level.ranges.size())});
+		for(const auto &range: level.ranges) {
+			if(!fits<std::uint32_t>(range.from) || !fits<std::uint32_t>(range.to) || !fits<std::uint8_t>(range.energies)
+			   || !fits<std::uint8_t>(range.empty) || !fits<std::uint16_t>(range.scramble)
+			   || !fits<std::uint16_t>(range.min_moves) || !fits<std::uint16_t>(range.max_moves)
+			   || !fits<std::uint32_t>(range.budget)) {
+				return pxe::error(std::format("cosmic range {}-{} does not fit the level pack", range.from, range.to));
+			}
+			ranges.push_back({.from = static_cast<std::uint32_t>(range.from),
+							  .to = static_cast<std::uint32_t>(range.to),
+							  .energies = static_cast<std::uint8_t>(range.energies),
+							  .empty = static_cast<std::uint8_t>(range.empty),
+							  .scramble = static_cast<std::uint16_t>(range.scramble),
+							  .min_moves = static_cast<std::uint16_t>(range.min_moves),
+							  .max_moves = static_cast<std::uint16_t>(range.max_moves),
+							  .budget = static_cast<std::uint32_t>(range.budget)});
+		}
+	}
+
+	const pack_header header{.magic = pack_magic,
+							 .version = pack_version,
+							 .classic = static_cast<std::uint32_t>(classic.size()),
+							 .cosmic = static_cast<std::uint32_t>(cosmic.size()),
+							 .ranges = static_cast<std::uint32_t>(ranges.size()),
+							 .reserved = 0,
+							 .sources = level_sources_hash().value_or(0)};
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if(!file.is_open()) {
+		return pxe::error(std::format("failed to create level pack: {}", path));
+	}
+	// NOLINTBEGIN(*-reinterpret-cast)
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char *>(classic.data()),
+			   static_cast<std::streamsize>(classic.size() * sizeof(pack_classic)));
+	file.write(reinterpret_cast<const char *>(cosmic.data()),
+			   static_cast<std::streamsize>(cosmic.size() * sizeof(pack_cosmic)));
+	file.write(reinterpret_cast<const char *>(ranges.data()),
+			   static_cast<std::streamsize>(ranges.size() * sizeof(pack_range)));
+	// NOLINTEND(*-reinterpret-cast)
+	if(!file) {
+		return pxe::error(std::format("failed to write level pack: {}", path));
+	}
+	return true;
+}
+
 auto level_manager::get_cosmic_data() const -> cosmic_level {
 	for(const auto &level: cosmic_levels_) {
 		if(level.difficult == current_difficulty_) {
@@ -155,6 +482,154 @@ auto level_manager::get_cosmic_data() const -> cosmic_level {
 	return {};
 }
 
+auto level_manager::get_cosmic_level_string(const difficulty level,
+											const size_t number,
+											const std::uint64_t seed) const -> pxe::result<std::string> {
+	const auto range = find_cosmic_range(level, number);
+	if(!range.has_value()) {
+		return pxe::error(std::format("no cosmic range for level {}", number));
+	}
+	const auto level_seed = cosmic_seed(level, number, seed);
+	if(range->scramble == 0) {
+		if(const auto stored =
+			   corpus_.draw(range->energies, range->empty, level_seed, range->min_moves, range->max_moves);
+		   stored.has_value()) {
+			return stored->puzzle;
+		}
+	}
+	rng engine{level_seed};
+	return generate_cosmic_level_string(shape_of(*range), engine);
+}
+
+auto level_manager::cosmic_seed(const difficulty level, const size_t number, const std::uint64_t seed)
+	-> std::uint64_t {
+	return rng::derive(rng::derive(seed, static_cast<std::uint64_t>(level)), number);
+}
+
+auto level_manager::scramble_cosmic_level_string(const size_t energies,
+												const size_t empty,
+												const size_t depth,
+												rng &engine) -> std::string {
+	return puzzle::scrambled(energies, empty, depth, engine).to_string();
+}
+
+auto level_manager::generate_cosmic_level_string(const cosmic_pool::shape &wanted,
+												 rng &engine,
+												 const std::stop_token &stop) -> std::string {
+	if(wanted.min_moves == 0 && wanted.max_moves == 0) {
+		return generate_cosmic_puzzle(wanted, engine, stop).to_string();
+	}
+	return generate_in_band(wanted, engine, stop);
+}
+
+auto level_manager::generate_cosmic_puzzle(const cosmic_pool::shape &wanted,
+										   rng &engine,
+										   const std::stop_token &stop) -> puzzle {
+	if(wanted.scramble > 0) {
+		return puzzle::scrambled(wanted.energies, wanted.empty, wanted.scramble, engine);
+	}
+	return random_solvable_puzzle(wanted.energies, wanted.empty, engine, stop);
+}
+
+// candidates are solved in fixed-size batches across threads and the first one inside the band wins; the
+// batch does not depend on the thread count, so the same engine state picks the same puzzle everywhere.
+// One pool serves every batch instead of starting threads for each of them
+auto level_manager::generate_in_band(const cosmic_pool::shape &wanted, rng &engine, const std::stop_token &stop)
+	-> std::string {
+	const auto base = engine();
+	const auto budget = wanted.budget > 0 ? wanted.budget : default_candidate_budget;
+	std::array<std::string, candidate_batch> candidates;
+	std::array<size_t, candidate_batch> moves{};
+	std::string closest;
+	auto closest_distance = std::numeric_limits<size_t>::max();
+	worker_pool pool{std::min(candidate_batch, hardware_threads())};
+	for(size_t first = 0; first < budget; first += candidate_batch) {
+		const auto batch = std::min(candidate_batch, budget - first);
+		pool.run(batch, [&](std::size_t, std::size_t begin, std::size_t end) -> void {
+			for(auto i = begin; i < end && !stop.stop_requested(); ++i) {
+				rng candidate_engine{rng::derive(base, first + i)};
+				const auto candidate = generate_cosmic_puzzle(wanted, candidate_engine, stop);
+				candidates.at(i) = candidate.to_string();
+				moves.at(i) = solver::a_star(candidate.pack(), stop).size();
+			}
+		});
+		if(stop.stop_requested()) {
+			return {};
+		}
+		for(size_t i = 0; i < batch; ++i) {
+			if(const auto distance = band_distance(moves.at(i), wanted); distance < closest_distance) {
+				closest = std::move(candidates.at(i));
+				closest_distance = distance;
+			}
+			if(closest_distance == 0) {
+				return closest;
+			}
+		}
+	}
+	return closest;
+}
+
+auto level_manager::band_distance(const size_t moves, const cosmic_pool::shape &wanted) -> size_t {
+	if(moves < wanted.min_moves) {
+		return wanted.min_moves - moves;
+	}
+	if(wanted.max_moves != 0 && moves > wanted.max_moves) {
+		return moves - wanted.max_moves;
+	}
+	return 0;
+}
+
+auto level_manager::shape_of(const cosmic_range &range) -> cosmic_pool::shape {
+	return {.energies = range.energies,
+			.empty = range.empty,
+			.scramble = range.scramble,
+			.min_moves = range.min_moves,
+			.max_moves = range.max_moves,
+			.budget = range.budget};
+}
+
+auto level_manager::fresh_seed() -> std::uint64_t {
+	std::random_device device;
+	return (static_cast<std::uint64_t>(device()) << 32U) ^ device();
+}
+
+auto level_manager::find_cosmic_range(const difficulty level, const size_t number) const
+	-> std::optional<cosmic_range> {
+	std::optional<cosmic_range> result;
+	for(const auto &range: get_cosmic_ranges(level)) {
+		if(number >= range.from && number <= range.to) {
+			result = range;
+		}
+	}
+	return result;
+}
+
+auto level_manager::prepare_cosmic_pool(const size_t first) -> void {
+	std::vector<cosmic_pool::level> wanted;
+	for(auto number = first; number < first + cosmic_lookahead; ++number) {
+		const auto range = find_cosmic_range(current_difficulty_, number);
+		if(range.has_value()
+		   && (range->scramble > 0
+			   || corpus_.count(range->energies, range->empty, range->min_moves, range->max_moves) == 0)) {
+			wanted.push_back(pool_level(number, *range));
+		}
+	}
+	cosmic_pool_.set_wanted(wanted);
+}
+
+auto level_manager::pool_level(const size_t number, const cosmic_range &range) const -> cosmic_pool::level {
+	return {.wanted = shape_of(range), .seed = cosmic_seed(current_difficulty_, number, cosmic_seed_)};
+}
+
+auto level_manager::get_cosmic_ranges(const difficulty level) const -> std::vector<cosmic_range> {
+	for(const auto &cosmic: cosmic_levels_) {
+		if(cosmic.difficult == level) {
+			return cosmic.ranges;
+		}
+	}
+	return {};
+}
+
 auto level_manager::parse_cosmic_level(const jsoncons::basic_json<char> &level) -> pxe::result<cosmic_level> {
 	if(!level.contains("difficult")
 	   || !level["difficult"].is_int64()) { // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
@@ -213,7 +688,47 @@ auto level_manager::parse_cosmic_range(const jsoncons::basic_json<char> &range)
 	new_range.to = range["to"].as<uint64_t>();			   // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
 	new_range.energies = range["energies"].as<uint64_t>(); // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
 	new_range.empty = range["empty"].as<uint64_t>();	   // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+	if(range.contains("scramble")) {
+		if(!range["scramble"].is_uint64()) { // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+			return pxe::error("cosmic range 'scramble' must be a uint");
+		}
+		new_range.scramble = range["scramble"].as<uint64_t>(); // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+	}
+	if(range.contains("moves")) {
+		const auto &moves = range["moves"]; // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+		if(const auto err = parse_move_band(moves, new_range).unwrap(); err) {
+			return pxe::error("failed to parse cosmic range 'moves'", *err);
+		}
+	}
+	if(range.contains("budget")) {
+		if(!range["budget"].is_uint64()) { // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+			return pxe::error("cosmic range 'budget' must be a uint");
+		}
+		new_range.budget = range["budget"].as<uint64_t>(); // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+	}
 	return new_range;
 }
 
+auto level_manager::parse_move_band(const jsoncons::basic_json<char> &moves, cosmic_range &range) -> pxe::result<> {
+	if(!moves.is_object()) {
+		return pxe::error("move band must be an object");
+	}
+	if(moves.contains("min")) {
+		if(!moves["min"].is_uint64()) { // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+			return pxe::error("move band 'min' must be a uint");
+		}
+		range.min_moves = moves["min"].as<uint64_t>(); // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+	}
+	if(moves.contains("max")) {
+		if(!moves["max"].is_uint64()) { // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+			return pxe::error("move band 'max' must be a uint");
+		}
+		range.max_moves = moves["max"].as<uint64_t>(); // NOLINT(*-pro-bounds-avoid-unchecked-container-access)
+	}
+	if(range.max_moves != 0 && range.max_moves < range.min_moves) {
+		return pxe::error("move band 'max' is below 'min'");
+	}
+	return true;
+}
+
 } // namespace energy
@@ -5,8 +5,16 @@
 
 #include <pxe/result.hpp>
 
+#include "data/cosmic_corpus.hpp"
+#include "data/cosmic_pool.hpp"
+#include "data/puzzle.hpp"
+#include "data/rng.hpp"
+
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <stop_token>
 #include <string>
 #include <vector>
 #include <jsoncons/basic_json.hpp>
@@ -24,10 +32,14 @@ public:
 	level_manager(level_manager &&) = delete;
 	auto operator=(level_manager &&) -> level_manager & = delete;
 
+	// from the level pack when it was built from the json files there are now, from the json files otherwise
 	auto load_levels() -> pxe::result<>;
 
 	auto set_current_level(const size_t level) -> void {
 		current_level_ = level;
+		if(current_mode_ == mode::cosmic) {
+			prepare_cosmic_pool(current_level_);
+		}
 	}
 	[[nodiscard]] auto get_current_level() const -> size_t {
 		return current_level_;
@@ -62,6 +74,11 @@ public:
 		current_mode_ = new_mode;
 		last_level_string_ = 0;
 		cached_level_string_.clear();
+		if(current_mode_ == mode::cosmic) {
+			cosmic_seed_ = fresh_seed();
+		} else {
+			cosmic_pool_.set_wanted({});
+		}
 	}
 
 	[[nodiscard]] auto get_mode() const -> mode {
@@ -79,20 +96,90 @@ public:
 	[[nodiscard]] auto get_game_time() const -> size_t;
 	[[nodiscard]] auto get_battery_time() const -> size_t;
 
-private:
-	static constexpr auto classic_levels_path = "resources/levels/classic.json";
-	static constexpr auto cosmic_levels_path = "resources/levels/cosmic.json";
-	std::vector<std::string> classic_levels_;
-
 	// =============================================================================
-	// Cosmic mode level data structures
+	// Cosmic mode generation, also used by the tools
 	struct cosmic_range {
 		size_t from;
 		size_t to;
 		size_t energies;
 		size_t empty;
+		// optional, reverse transfers from a solved board; zero generates random boards and checks them
+		size_t scramble;
+		// optional band of optimal moves, zero max_moves has no upper bound, and how many candidates are
+		// solved looking for one inside it before the closest is taken
+		size_t min_moves;
+		size_t max_moves;
+		size_t budget;
+	};
+
+	static constexpr size_t default_candidate_budget = 64;
+
+	[[nodiscard]] auto get_cosmic_ranges(difficulty level) const -> std::vector<cosmic_range>;
+	static auto generate_cosmic_level_string(size_t energies, size_t empty, rng &engine) -> std::string;
+	static auto scramble_cosmic_level_string(size_t energies, size_t empty, size_t depth, rng &engine)
+		-> std::string;
+	// everything a range asks for: scrambled or random boards, searched for the move band when it has one
+	[[nodiscard]] static auto shape_of(const cosmic_range &range) -> cosmic_pool::shape;
+	// a stop request gives up between candidates and returns an empty string
+	static auto generate_cosmic_level_string(const cosmic_pool::shape &wanted,
+											 rng &engine,
+											 const std::stop_token &stop = {}) -> std::string;
+
+	// how random candidates were settled by the solvability filter since the last reset, cheapest tier
+	// first: no legal move at all, a bounded probe, then the full search; shared by every generating thread
+	struct filter_stats {
+		size_t candidates;
+		size_t structural_rejects;
+		size_t probe_rejects;
+		size_t probe_accepts;
+		size_t search_rejects;
+		size_t search_accepts;
+	};
+
+	[[nodiscard]] static auto get_filter_stats() -> filter_stats;
+	static auto reset_filter_stats() -> void;
+
+	// the same (difficulty, level, seed) always gives the same puzzle, from the corpus when it covers an
+	// unscrambled range and generated otherwise; a new seed is picked every time cosmic mode is entered
+	[[nodiscard]] auto get_cosmic_level_string(difficulty level, size_t number, std::uint64_t seed) const
+		-> pxe::result<std::string>;
+	[[nodiscard]] static auto cosmic_seed(difficulty level, size_t number, std::uint64_t seed) -> std::uint64_t;
+
+	auto set_cosmic_seed(const std::uint64_t seed) -> void {
+		cosmic_seed_ = seed;
+	}
+	[[nodiscard]] auto get_cosmic_seed() const -> std::uint64_t {
+		return cosmic_seed_;
+	}
+
+	// =============================================================================
+	// Classic level file entries, moves is the recorded optimal solution length when present
+	struct classic_level {
+		std::string puzzle;
+		std::optional<size_t> moves;
 	};
 
+	[[nodiscard]] static auto read_classic_levels(const std::string &levels_path)
+		-> pxe::result<std::vector<classic_level>>;
+
+	// =============================================================================
+	// Level pack, the json files are the authoring format and energy-swap-pack converts them into fixed-size
+	// records that load with one read and no parsing; a pack keeps a hash of the json files it was built from
+	// and is refused once they change, json files that are not there (a build that only ships the pack) are
+	// not checked
+	auto load_json_levels() -> pxe::result<>;
+	auto load_level_pack(const std::string &path) -> pxe::result<>;
+	[[nodiscard]] auto write_level_pack(const std::string &path) const -> pxe::result<>;
+
+private:
+	static constexpr auto classic_levels_path = "resources/levels/classic.json";
+	static constexpr auto cosmic_levels_path = "resources/levels/cosmic.json";
+	static constexpr auto cosmic_corpus_path = "resources/levels/cosmic.bin";
+	static constexpr auto level_pack_path = "resources/levels/levels.bin";
+	std::vector<classic_level> classic_levels_;
+
+	// =============================================================================
+	// Cosmic mode level data structures
 	struct cosmic_level {
 		difficulty difficult;
 		std::vector<cosmic_range> ranges;
@@ -108,17 +195,55 @@ private:
 	mode current_mode_{mode::classic};
 	difficulty current_difficulty_{difficulty::normal};
 
-	static auto generate_cosmic_level_string(size_t energies, size_t empty) -> std::string;
 	auto load_classic_levels(const std::string &levels_path) -> pxe::result<>;
 	auto load_cosmic_levels(const std::string &levels_path) -> pxe::result<>;
+	[[nodiscard]] static auto level_sources_hash() -> std::optional<std::uint64_t>;
 
 	size_t last_level_string_ = 0;
 	std::string cached_level_string_;
 
 	[[nodiscard]] auto get_cosmic_data() const -> cosmic_level;
+	[[nodiscard]] auto find_cosmic_range(difficulty level, size_t number) const -> std::optional<cosmic_range>;
+
+	cosmic_corpus corpus_;
+	std::uint64_t cosmic_seed_ = 0;
+	[[nodiscard]] static auto fresh_seed() -> std::uint64_t;
+	[[nodiscard]] static auto random_solvable_puzzle(size_t energies,
+													 size_t empty,
+													 rng &engine,
+													 const std::stop_token &stop = {}) -> puzzle;
+	[[nodiscard]] static auto generate_cosmic_puzzle(const cosmic_pool::shape &wanted,
+													 rng &engine,
+													 const std::stop_token &stop) -> puzzle;
+	[[nodiscard]] static auto generate_in_band(const cosmic_pool::shape &wanted,
+											   rng &engine,
+											   const std::stop_token &stop) -> std::string;
+	[[nodiscard]] static auto band_distance(size_t moves, const cosmic_pool::shape &wanted) -> size_t;
+	static constexpr size_t candidate_batch = 8;
+
+	struct filter_counters {
+		std::atomic<size_t> candidates;
+		std::atomic<size_t> structural_rejects;
+		std::atomic<size_t> probe_rejects;
+		std::atomic<size_t> probe_accepts;
+		std::atomic<size_t> search_rejects;
+		std::atomic<size_t> search_accepts;
+	};
+	static inline filter_counters filter_counters_{};
+
+	// the next levels the corpus does not serve are generated ahead on a background thread, each from the
+	// seed it would be generated from on the spot
+	static constexpr size_t cosmic_lookahead = 3;
+	cosmic_pool cosmic_pool_{[](const cosmic_pool::level &next, const std::stop_token &stop) -> std::string {
+		rng engine{next.seed};
+		return generate_cosmic_level_string(next.wanted, engine, stop);
+	}};
+	auto prepare_cosmic_pool(size_t first) -> void;
+	[[nodiscard]] auto pool_level(size_t number, const cosmic_range &range) const -> cosmic_pool::level;
 
 	static auto parse_cosmic_level(const jsoncons::basic_json<char> &level) -> pxe::result<cosmic_level>;
 	static auto parse_cosmic_range(const jsoncons::basic_json<char> &range) -> pxe::result<cosmic_range>;
+	static auto parse_move_band(const jsoncons::basic_json<char> &moves, cosmic_range &range) -> pxe::result<>;
 };
 
 } // namespace energy
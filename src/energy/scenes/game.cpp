@@ -13,7 +13,10 @@
 #include "../components/battery_display.hpp"
 #include "../components/points.hpp"
 #include "../components/spark.hpp"
+#include "../data/packed_puzzle.hpp"
+#include "../data/parallel.hpp"
 #include "../data/puzzle.hpp"
+#include "../data/solver.hpp"
 #include "../energy_swap.hpp"
 #include "../level_manager.hpp"
 
@@ -21,15 +24,20 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <format>
+#include <future>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <ranges>
 #include <raygui.h>
 #include <spdlog/spdlog.h>
+#include <stop_token>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace energy {
@@ -67,11 +75,14 @@ auto game::init(pxe::app &app) -> pxe::result<> {
 
 	battery_click_ = app.bind_event<battery_display::click>(this, &game::on_battery_click);
 	button_click_ = app.bind_event<pxe::button::click>(this, &game::on_button_click);
+	hint_ready_ = app.bind_event<hint_ready>(this, &game::on_hint_ready);
 
 	return true;
 }
 
 auto game::end() -> pxe::result<> {
+	cancel_solution_hint();
+	get_app().unsubscribe(hint_ready_);
 	get_app().unsubscribe(button_click_);
 	get_app().unsubscribe(battery_click_);
 
@@ -137,6 +148,10 @@ auto game::update(const float delta) -> pxe::result<> {
 		return pxe::error("failed to update base scene", *err);
 	}
 
+	if(const auto err = poll_solution_hint().unwrap(); err) {
+		return pxe::error("failed to poll solution hint", *err);
+	}
+
 	if(get_app().is_in_controller_mode()) {
 		if(const auto err = update_controller_input().unwrap(); err) {
 			return pxe::error("failed to update controller input", *err);
@@ -614,7 +629,7 @@ auto game::on_battery_click(const battery_display::click &click) -> pxe::result<
 		return pxe::error("failed to handle battery transfer", *err);
 	}
 
-	if(got_hint_ && can_have_solution_hint_) {
+	if(can_have_solution_hint_) {
 		// if we handle a transfer get a hint, this includes when we deselect a battery, or we need the next hint
 		if(const auto err = calculate_solution_hint().unwrap(); err) {
 			return pxe::error("failed to calculate solution hint", *err);
@@ -636,6 +651,36 @@ auto game::on_button_click(const pxe::button::click &evt) -> pxe::result<> {
 	return true;
 }
 
+auto game::on_hint_ready(const hint_ready &evt) -> pxe::result<> {
+	// a result for a board that has changed since it was requested is dropped
+	if(!thinking_ || evt.generation != hint_generation_) {
+		return true;
+	}
+	thinking_ = false;
+
+	std::shared_ptr<pxe::label> status_ptr;
+	if(const auto err = get_component<pxe::label>(status_).unwrap(status_ptr); err) {
+		return pxe::error("failed to get status label", *err);
+	}
+	status_ptr->set_text("");
+
+	if(evt.moves.empty()) {
+		return true;
+	}
+	const auto [from, to] = evt.moves.front();
+	hint_from_ = from;
+	hint_to_ = to;
+	hint_state_ = hint_request_;
+	hint_hash_ = hint_request_.hash();
+	hint_path_ = evt.moves;
+	hint_step_ = 0;
+	got_hint_ = true;
+	if(const auto err = reset_hint_indicators().unwrap(); err) {
+		return pxe::error("failed to reset hint indicators", *err);
+	}
+	return set_hint_to_battery(from, true);
+}
+
 // ============================================================================
 // Battery Click Processing
 // ============================================================================
@@ -963,24 +1008,93 @@ auto game::calculate_solution_hint() -> pxe::result<> {
 		return true;
 	}
 
-	got_hint_ = false;
-	if(current_puzzle_.is_solved()) {
-		return true;
-	}
-	if(const auto solution_moves = current_puzzle_.solve(); !solution_moves.empty()) {
-		const auto [from, to] = solution_moves.front();
-		hint_from_ = from;
-		hint_to_ = to;
-		got_hint_ = true;
+	// the hash ignores battery order, so confirm with the packed state before reusing the hint indices
+	if(got_hint_ && hint_hash_ == current_puzzle_.hash() && hint_state_ == current_puzzle_.pack()) {
 		if(const auto err = reset_hint_indicators().unwrap(); err) {
 			return pxe::error("failed to reset hint indicators", *err);
 		}
-		if(const auto err = set_hint_to_battery(from, true).unwrap(); err) {
-			return pxe::error("failed to set hint to battery", *err);
-		}
+		return set_hint_to_battery(hint_from_, true);
+	}
+
+	// the same board is already being solved, for example after a deselect, or after a reset that cleared the
+	// status
+	if(thinking_ && hint_request_ == current_puzzle_.pack()) {
+		return show_thinking();
+	}
+
+	got_hint_ = false;
+	cancel_solution_hint();
+	if(const auto err = reset_hint_indicators().unwrap(); err) {
+		return pxe::error("failed to reset hint indicators", *err);
+	}
+	if(current_puzzle_.is_solved() || !current_puzzle_.is_solvable()) {
+		return true;
+	}
+	return start_solution_hint();
+}
+
+auto game::start_solution_hint() -> pxe::result<> {
+	if(const auto err = show_thinking().unwrap(); err) {
+		return pxe::error("failed to show thinking status", *err);
+	}
+	thinking_ = true;
+	hint_request_ = current_puzzle_.pack();
+
+	// without threads the solve runs right here, the result still arrives as an event
+	if constexpr(!threads_available) {
+		get_app().post_event(hint_ready{.generation = hint_generation_, .moves = solver::a_star(hint_request_)});
+		return true;
+	}
+
+	std::promise<std::vector<puzzle::move>> promise;
+	hint_result_ = promise.get_future().share();
+	hint_worker_ = std::jthread(
+		[state = hint_request_, promise = std::move(promise)](const std::stop_token &stop) mutable -> void {
+			promise.set_value(solver::a_star(state, stop));
+		});
+	return true;
+}
+
+auto game::show_thinking() const -> pxe::result<> {
+	std::shared_ptr<pxe::label> status_ptr;
+	if(const auto err = get_component<pxe::label>(status_).unwrap(status_ptr); err) {
+		return pxe::error("failed to get status label", *err);
+	}
+	status_ptr->set_text(thinking_message);
+	return true;
+}
+
+// a stopped search returns within one node expansion, so the join does not hold the frame
+auto game::cancel_solution_hint() -> void {
+	if(hint_worker_.joinable()) {
+		hint_worker_.request_stop();
+		hint_worker_.join();
+	}
+	hint_result_ = {};
+	thinking_ = false;
+	++hint_generation_;
+}
+
+auto game::poll_solution_hint() -> pxe::result<> {
+	if(!hint_result_.valid() || hint_result_.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
 		return true;
 	}
-	return pxe::error("no solution found for current puzzle state");
+	get_app().post_event(hint_ready{.generation = hint_generation_, .moves = hint_result_.get()});
+	hint_result_ = {};
+	return true;
+}
+
+// the rest of an optimal path is still optimal, so following the hint only steps along it and the
+// next calculate_solution_hint finds the new state cached; any other move leaves the cache stale
+auto game::advance_solution_hint(const puzzle::move &played) -> void {
+	if(!got_hint_ || played.from != hint_from_ || played.to != hint_to_ || hint_step_ + 1 >= hint_path_.size()) {
+		return;
+	}
+	hint_state_.transfer(played.from, played.to);
+	hint_hash_ = hint_state_.hash();
+	const auto [from, to] = hint_path_.at(++hint_step_);
+	hint_from_ = from;
+	hint_to_ = to;
 }
 
 auto game::reset_hint_indicators() const -> pxe::result<> {
@@ -997,7 +1111,9 @@ auto game::execute_energy_transfer(const std::shared_ptr<battery_display> &from,
 		return pxe::error("failed to shoot sparks", *err);
 	}
 
-	to->transfer_energy_from(*from);
+	const puzzle::move played{.from = from->get_index(), .to = to->get_index()};
+	current_puzzle_.transfer(played);
+	advance_solution_hint(played);
 
 	if(is_cosmic_level_) {
 		if(to->is_battery_closed()) {
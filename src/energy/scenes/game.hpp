@@ -12,14 +12,19 @@
 #include "../components/battery_display.hpp"
 #include "../components/points.hpp"
 #include "../components/spark.hpp"
+#include "../data/packed_puzzle.hpp"
 #include "../data/puzzle.hpp"
 
 #include <raylib.h>
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <future>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace pxe {
 class app;
@@ -51,6 +56,10 @@ public:
 	struct next_level {};
 	struct reset_level {};
 	struct back {};
+	struct hint_ready {
+		std::uint64_t generation;
+		std::vector<puzzle::move> moves;
+	};
 
 private:
 	static constexpr auto max_batteries = 12;
@@ -81,6 +90,7 @@ private:
 	puzzle current_puzzle_{};
 	int battery_click_{};
 	int button_click_{};
+	int hint_ready_{};
 
 	// ========================================================================
 	// Initialization
@@ -125,6 +135,7 @@ private:
 
 	auto on_battery_click(const battery_display::click &click) -> pxe::result<>;
 	auto on_button_click(const pxe::button::click &evt) -> pxe::result<>;
+	auto on_hint_ready(const hint_ready &evt) -> pxe::result<>;
 
 	// ========================================================================
 	// Battery Click Processing
@@ -184,11 +195,29 @@ private:
 	// Solution hint
 	size_t hint_from_{0};
 	size_t hint_to_{0};
+	std::uint64_t hint_hash_{0};
+	packed_puzzle hint_state_{};
+	std::vector<puzzle::move> hint_path_;
+	size_t hint_step_{0};
 	bool got_hint_{false};
 	bool can_have_solution_hint_{true};
 	[[nodiscard]] auto set_hint_to_battery(size_t battery_num, bool is_hint) const -> pxe::result<>;
 	[[nodiscard]] auto reset_hint_indicators() const -> pxe::result<>;
 	[[nodiscard]] auto calculate_solution_hint() -> pxe::result<>;
+	auto advance_solution_hint(const puzzle::move &played) -> void;
+
+	// the solve runs on a worker thread on its own copy of the board, update polls for the result and
+	// posts it as a hint_ready event; any newer request bumps the generation, stops the old one and joins it
+	std::jthread hint_worker_;
+	std::shared_future<std::vector<puzzle::move>> hint_result_;
+	std::uint64_t hint_generation_{0};
+	packed_puzzle hint_request_{};
+	bool thinking_{false};
+	static auto constexpr thinking_message = "Thinking ...";
+	[[nodiscard]] auto start_solution_hint() -> pxe::result<>;
+	[[nodiscard]] auto show_thinking() const -> pxe::result<>;
+	auto cancel_solution_hint() -> void;
+	[[nodiscard]] auto poll_solution_hint() -> pxe::result<>;
 
 	bool is_cosmic_level_{false};
 	float remaining_time_{0.0F};
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <source_location>
+#include <string_view>
+
+namespace energy::test {
+
+// Minimal checks for the unit tests: a failed check is reported with its location and the test keeps
+// going, result() is what main returns
+inline auto failures = 0;
+
+inline auto check(const bool condition,
+				  const std::string_view what,
+				  const std::source_location where = std::source_location::current()) -> void {
+	if(!condition) {
+		std::cerr << std::format("{}:{}: check failed: {}\n", where.file_name(), where.line(), what);
+		++failures;
+	}
+}
+
+[[nodiscard]] inline auto result() -> int {
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace energy::test
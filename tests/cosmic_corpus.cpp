@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "../src/energy/data/cosmic_corpus.hpp"
+#include "check.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using energy::test::check;
+
+auto temp_path() -> std::string {
+	return (std::filesystem::temp_directory_path() / "energy-swap-test-corpus.bin").string();
+}
+
+auto test_round_trip() -> void {
+	const std::vector<energy::cosmic_corpus::shape_levels> shapes{
+		{.energies = 2,
+		 .empty = 1,
+		 .levels = {{.puzzle = "121221210000", .moves = 4}, {.puzzle = "112222110000", .moves = 2}}},
+		{.energies = 3, .empty = 2, .levels = {{.puzzle = "12312312312300000000", .moves = 7}}}};
+	const auto path = temp_path();
+	check(!energy::cosmic_corpus::write(path, shapes).unwrap(), "corpus is written");
+
+	energy::cosmic_corpus corpus;
+	check(!corpus.open(path).unwrap(), "written corpus opens");
+	check(corpus.count(2, 1) == 2 && corpus.count(3, 2) == 1, "every shape keeps its levels");
+	check(corpus.count(4, 1) == 0 && !corpus.draw(4, 1, 1).has_value(), "missing shapes have no levels");
+	check(corpus.count(2, 1, 3, 5) == 1, "counts only levels within the move band");
+
+	const auto first = corpus.at(2, 1, 0);
+	check(first.has_value() && first->puzzle == "121221210000" && first->moves == 4, "level decodes as written");
+	const auto last = corpus.at(3, 2, 0);
+	check(last.has_value() && last->puzzle == "12312312312300000000" && last->moves == 7, "empty batteries survive");
+	check(!corpus.at(3, 2, 1).has_value(), "index past the shape has no level");
+
+	const auto drawn = corpus.draw(2, 1, 42, 3, 5);
+	check(drawn.has_value() && drawn->moves == 4, "draw stays within the move band");
+	const auto again = corpus.draw(2, 1, 42);
+	check(again.has_value() && again->puzzle == corpus.draw(2, 1, 42)->puzzle, "same seed draws the same level");
+	corpus.close();
+	std::filesystem::remove(path);
+}
+
+// a single shape of two energies and one empty battery holding one level
+auto one_level(const std::string &puzzle, const std::size_t moves) -> std::vector<energy::cosmic_corpus::shape_levels> {
+	return {{.energies = 2, .empty = 1, .levels = {{.puzzle = puzzle, .moves = moves}}}};
+}
+
+auto test_write_rejects_overflow() -> void {
+	const auto path = temp_path();
+	check(energy::cosmic_corpus::write(path, one_level("121221210000", 256)).unwrap().has_value(),
+		  "moves past one byte fail the write");
+	check(energy::cosmic_corpus::write(path, {{.energies = 256, .empty = 1, .levels = {}}}).unwrap().has_value(),
+		  "energies past one byte fail the write");
+	check(energy::cosmic_corpus::write(path, one_level("123", 1)).unwrap().has_value(),
+		  "invalid puzzle fails the write");
+	std::filesystem::remove(path);
+}
+
+auto test_open_rejects_bad_files() -> void {
+	const auto path = temp_path();
+	check(!energy::cosmic_corpus::write(path, one_level("121221210000", 4)).unwrap(), "corpus is written");
+	const auto size = std::filesystem::file_size(path);
+	std::filesystem::resize_file(path, size - 1);
+	energy::cosmic_corpus corpus;
+	check(corpus.open(path).unwrap().has_value(), "truncated corpus does not open");
+
+	std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a corpus at all";
+	check(corpus.open(path).unwrap().has_value(), "unknown format does not open");
+	std::filesystem::remove(path);
+	check(corpus.open(path).unwrap().has_value(), "missing file does not open");
+}
+
+} // namespace
+
+auto main() -> int {
+	test_round_trip();
+	test_write_rejects_overflow();
+	test_open_rejects_bad_files();
+	return energy::test::result();
+}
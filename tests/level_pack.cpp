@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "../src/energy/data/packed_puzzle.hpp"
+#include "../src/energy/data/puzzle.hpp"
+#include "../src/energy/level_manager.hpp"
+#include "check.hpp"
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+using energy::level_manager;
+using energy::test::check;
+
+constexpr auto shipped_pack = "resources/levels/levels.bin";
+constexpr std::array difficulties{
+	level_manager::difficulty::normal, level_manager::difficulty::hard, level_manager::difficulty::burger_daddy};
+
+// compared as boards, the pack writes hex digits in upper case whatever case the json used
+auto classic_levels(level_manager &levels) -> std::vector<energy::packed_puzzle> {
+	std::vector<energy::packed_puzzle> result;
+	for(std::size_t level = 1; level <= levels.get_total_levels(); ++level) {
+		levels.set_current_level(level);
+		std::string text;
+		check(!levels.get_current_level_string().unwrap(text), "classic level string is available");
+		energy::puzzle parsed;
+		check(!energy::puzzle::from_string(text).unwrap(parsed), "classic level parses");
+		result.push_back(parsed.pack());
+	}
+	return result;
+}
+
+auto same_ranges(const level_manager &lhs, const level_manager &rhs, const level_manager::difficulty level) -> bool {
+	const auto left = lhs.get_cosmic_ranges(level);
+	const auto right = rhs.get_cosmic_ranges(level);
+	if(left.size() != right.size()) {
+		return false;
+	}
+	for(std::size_t i = 0; i < left.size(); ++i) {
+		const auto &a = left.at(i);
+		const auto &b = right.at(i);
+		if(a.from != b.from || a.to != b.to || a.energies != b.energies || a.empty != b.empty
+		   || a.scramble != b.scramble || a.min_moves != b.min_moves || a.max_moves != b.max_moves
+		   || a.budget != b.budget) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// everything the game reads from the levels, whichever format they came from
+auto check_same_levels(level_manager &lhs, level_manager &rhs) -> void {
+	check(classic_levels(lhs) == classic_levels(rhs), "classic levels match");
+	for(const auto difficulty: difficulties) {
+		check(same_ranges(lhs, rhs, difficulty), "cosmic ranges match");
+		lhs.set_difficulty(difficulty);
+		rhs.set_difficulty(difficulty);
+		check(lhs.get_game_time() == rhs.get_game_time() && lhs.get_battery_time() == rhs.get_battery_time(),
+			  "cosmic times match");
+	}
+}
+
+auto read_file(const std::filesystem::path &path) -> std::string {
+	std::ifstream file(path, std::ios::binary);
+	return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+auto write_file(const std::filesystem::path &path, const std::string &content) -> void {
+	std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+
+auto test_shipped_pack_is_current() -> void {
+	level_manager json;
+	check(!json.load_json_levels().unwrap(), "json levels load");
+	level_manager packed;
+	check(!packed.load_level_pack(shipped_pack).unwrap(), "shipped pack matches the json levels, run energy-swap-pack");
+	check_same_levels(json, packed);
+}
+
+auto test_round_trip() -> void {
+	const auto path = (std::filesystem::temp_directory_path() / "energy-swap-test-levels.bin").string();
+	level_manager json;
+	check(!json.load_json_levels().unwrap(), "json levels load");
+	check(!json.write_level_pack(path).unwrap(), "level pack is written");
+	level_manager packed;
+	check(!packed.load_level_pack(path).unwrap(), "written pack loads");
+	check_same_levels(json, packed);
+
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+	check(packed.load_level_pack(path).unwrap().has_value(), "truncated pack does not load");
+	write_file(path, "not a level pack at all");
+	check(packed.load_level_pack(path).unwrap().has_value(), "unknown format does not load");
+	std::filesystem::remove(path);
+	check(packed.load_level_pack(path).unwrap().has_value(), "missing pack does not load");
+}
+
+// the json files are looked up from the working directory, so the check runs on copies in a scratch one
+auto test_edited_sources_make_it_stale() -> void {
+	const auto source = std::filesystem::current_path();
+	const auto scratch = std::filesystem::temp_directory_path() / "energy-swap-test-levels";
+	const auto levels = scratch / "resources" / "levels";
+	std::filesystem::create_directories(levels);
+	for(const auto *name: {"classic.json", "cosmic.json"}) {
+		std::filesystem::copy_file(source / "resources" / "levels" / name,
+								   levels / name,
+								   std::filesystem::copy_options::overwrite_existing);
+	}
+	std::filesystem::current_path(scratch);
+
+	level_manager manager;
+	check(!manager.load_json_levels().unwrap(), "copied json levels load");
+	check(!manager.write_level_pack(shipped_pack).unwrap(), "level pack is written");
+	check(!manager.load_level_pack(shipped_pack).unwrap(), "fresh pack loads");
+
+	const auto cosmic = read_file(levels / "cosmic.json");
+	std::string windows;
+	for(const auto value: cosmic) {
+		windows += value == '\n' ? "\r\n" : std::string(1, value);
+	}
+	write_file(levels / "cosmic.json", windows);
+	check(!manager.load_level_pack(shipped_pack).unwrap(), "line endings do not make the pack stale");
+
+	write_file(levels / "cosmic.json", cosmic + " ");
+	check(manager.load_level_pack(shipped_pack).unwrap().has_value(), "edited json makes the pack stale");
+
+	std::filesystem::remove(levels / "classic.json");
+	std::filesystem::remove(levels / "cosmic.json");
+	check(!manager.load_level_pack(shipped_pack).unwrap(), "pack without json files is not checked");
+
+	std::filesystem::current_path(source);
+	std::filesystem::remove_all(scratch);
+}
+
+} // namespace
+
+auto main() -> int {
+	test_shipped_pack_is_current();
+	test_round_trip();
+	test_edited_sources_make_it_stale();
+	return energy::test::result();
+}
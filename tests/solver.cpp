@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "../src/energy/data/packed_puzzle.hpp"
+#include "../src/energy/data/puzzle.hpp"
+#include "../src/energy/data/rng.hpp"
+#include "../src/energy/data/solver.hpp"
+#include "../src/energy/data/transposition_table.hpp"
+#include "../src/energy/level_manager.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <format>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace {
+
+using energy::test::check;
+
+// the classic levels up to this one are small enough for the uninformed searches in a debug build
+constexpr std::size_t checked_levels = 60;
+constexpr auto random_boards = 200;
+
+constexpr std::array strategies{energy::puzzle::strategy::breadth_first,
+								energy::puzzle::strategy::depth_first,
+								energy::puzzle::strategy::a_star,
+								energy::puzzle::strategy::ida_star,
+								energy::puzzle::strategy::parallel_breadth_first,
+								energy::puzzle::strategy::bidirectional};
+
+auto parse(const std::string &text) -> energy::puzzle {
+	energy::puzzle result;
+	check(!energy::puzzle::from_string(text).unwrap(result), "puzzle string parses");
+	return result;
+}
+
+// plays every move checking it is legal, and that the move counter kept by the puzzle stays exact
+auto solves(energy::puzzle board, const std::vector<energy::puzzle::move> &moves) -> bool {
+	for(const auto &played: moves) {
+		if(played.from >= board.size() || played.to >= board.size()
+		   || !board.pack().can_transfer(played.from, played.to)) {
+			return false;
+		}
+		board.transfer(played);
+		check(board.legal_move_count() == board.pack().legal_move_count(), "legal move counter follows transfers");
+	}
+	return board.is_solved();
+}
+
+auto classic_levels() -> std::vector<energy::level_manager::classic_level> {
+	std::vector<energy::level_manager::classic_level> result;
+	check(!energy::level_manager::read_classic_levels("resources/levels/classic.json").unwrap(result),
+		  "classic levels load");
+	result.resize(std::min(result.size(), checked_levels));
+	return result;
+}
+
+// depth-first finds a solution but not the shortest, every other strategy matches the recorded optimum
+auto test_strategies_agree() -> void {
+	for(const auto &[text, moves]: classic_levels()) {
+		const auto board = parse(text);
+		for(const auto mode: strategies) {
+			energy::transposition_table::session().clear();
+			const auto solution = board.solve(mode);
+			check(solves(board, solution), "solution plays to a solved board");
+			if(mode != energy::puzzle::strategy::depth_first && moves.has_value()) {
+				check(solution.size() == *moves, "solution has the recorded optimal length");
+			}
+		}
+	}
+}
+
+// the same board with its colors relabeled, the largest color swapped with 1 and so on
+auto reverse_colors(const std::string &text) -> std::string {
+	const auto digit = [](const char value) -> int { return std::stoi(std::string(1, value), nullptr, 16); };
+	auto highest = 0;
+	for(const auto value: text) {
+		highest = std::max(highest, digit(value));
+	}
+	std::string result;
+	for(const auto value: text) {
+		const auto color = digit(value);
+		result += std::format("{:X}", color == 0 ? 0 : highest + 1 - color);
+	}
+	return result;
+}
+
+// color-canonical keys merge boards that only differ by their labels: visited sets, the session table
+// replaying a path found on a relabeled board and the bidirectional join must all still give playable
+// optimal solutions
+auto test_color_symmetry() -> void {
+	energy::solver::set_color_symmetry(true);
+	test_strategies_agree();
+	// colors tied on placement keep their label order, so not every relabeled board shares its key
+	auto recalled = 0;
+	for(const auto &level: classic_levels()) {
+		energy::transposition_table::session().clear();
+		const auto original = parse(level.puzzle).solve(energy::puzzle::strategy::a_star);
+		const auto relabeled = parse(reverse_colors(level.puzzle));
+		energy::solver::reset_expanded_nodes();
+		const auto replayed = relabeled.solve(energy::puzzle::strategy::a_star);
+		recalled += energy::solver::expanded_nodes() == 0 ? 1 : 0;
+		check(solves(relabeled, replayed), "path recalled for a relabeled board plays to a solved board");
+		check(replayed.size() == original.size(), "relabeled board keeps the optimal length");
+	}
+	check(recalled > 0, "relabeled boards are answered by the session table");
+	energy::solver::set_color_symmetry(false);
+}
+
+// pruned successors only ever repeat or mirror another one, so without the pruning every strategy finds
+// solutions of the same length
+auto test_move_pruning() -> void {
+	energy::solver::set_move_pruning(false);
+	test_strategies_agree();
+	energy::solver::set_move_pruning(true);
+}
+
+// admissible along an optimal path, and consistent: one move never lowers the bound by more than one
+auto test_heuristic_bounds() -> void {
+	for(const auto &level: classic_levels()) {
+		auto state = parse(level.puzzle).pack();
+		const auto solution = energy::solver::a_star(state);
+		auto remaining = static_cast<int>(solution.size());
+		for(const auto &[from, to]: solution) {
+			const auto before = energy::solver::heuristic(state);
+			check(before <= remaining, "heuristic never overestimates");
+			state.transfer(from, to);
+			check(before <= 1 + energy::solver::heuristic(state), "heuristic is consistent");
+			--remaining;
+		}
+		check(energy::solver::heuristic(state) == 0, "solved board has a zero bound");
+	}
+}
+
+auto test_unsolvable_boards() -> void {
+	for(const auto mode: strategies) {
+		energy::transposition_table::session().clear();
+		check(parse("12122121").solve(mode).empty(), "board without a free battery has no solution");
+	}
+	check(energy::solver::probe_solvable(parse("12122121").pack()) == false, "probe settles a small dead end");
+	check(energy::solver::probe_solvable(parse("111122220000").pack()) == true, "probe accepts a solved board");
+}
+
+// a probe answer, when it has one, is the answer of the full search
+auto test_probe_agrees_with_search() -> void {
+	energy::rng engine{0x7E57'0001ULL};
+	for(auto i = 0; i < random_boards; ++i) {
+		const auto board = energy::puzzle::random(2 + (engine() % 3), 1 + (engine() % 2), engine);
+		if(const auto probed = energy::solver::probe_solvable(board.pack()); probed.has_value()) {
+			check(*probed == (board.is_solved() || !energy::solver::a_star(board.pack()).empty()),
+				  "probe agrees with the full search");
+		}
+	}
+}
+
+// a board walked back from a solved one can always be played forward again, in no more moves than the walk
+auto test_scrambled_boards_are_solvable() -> void {
+	energy::rng engine{0x7E57'0002ULL};
+	for(auto i = 0; i < random_boards; ++i) {
+		const auto depth = 1 + static_cast<std::size_t>(engine() % 12);
+		const auto board = energy::puzzle::scrambled(2 + (engine() % 4), 1 + (engine() % 2), depth, engine);
+		if(board.is_solved()) {
+			continue;
+		}
+		const auto solution = energy::solver::a_star(board.pack());
+		check(!solution.empty() && solution.size() <= depth, "scrambled board solves within its depth");
+	}
+}
+
+// a cancelled search proves nothing, so it must not leave the board marked unsolvable
+auto test_stopped_search_is_not_remembered() -> void {
+	energy::transposition_table::session().clear();
+	const auto board = parse("121221210000").pack();
+	std::stop_source source;
+	source.request_stop();
+	check(energy::solver::a_star(board, source.get_token()).empty(), "stopped a_star gives up");
+	check(energy::solver::depth_first(board, source.get_token()).empty(), "stopped depth_first gives up");
+	check(!energy::solver::a_star(board).empty(), "the board still solves afterwards");
+}
+
+} // namespace
+
+auto main() -> int {
+	test_strategies_agree();
+	test_color_symmetry();
+	test_move_pruning();
+	test_heuristic_bounds();
+	test_unsolvable_boards();
+	test_probe_agrees_with_search();
+	test_scrambled_boards_are_solvable();
+	test_stopped_search_is_not_remembered();
+	return energy::test::result();
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+#include "../src/energy/data/packed_puzzle.hpp"
+#include "../src/energy/data/puzzle.hpp"
+#include "../src/energy/data/transposition_table.hpp"
+#include "check.hpp"
+
+#include <array>
+#include <string>
+
+namespace {
+
+using energy::test::check;
+
+constexpr std::array strategies{energy::puzzle::strategy::breadth_first,
+								energy::puzzle::strategy::depth_first,
+								energy::puzzle::strategy::a_star,
+								energy::puzzle::strategy::ida_star,
+								energy::puzzle::strategy::parallel_breadth_first,
+								energy::puzzle::strategy::bidirectional};
+
+auto parse(const std::string &text) -> energy::puzzle {
+	energy::puzzle result;
+	check(!energy::puzzle::from_string(text).unwrap(result), "puzzle string parses");
+	return result;
+}
+
+auto test_store_and_find() -> void {
+	energy::transposition_table table{2};
+	const auto first = parse("11222211").pack().canonical();
+	const auto second = parse("12122121").pack().canonical();
+	const auto third = parse("11112222").pack().canonical();
+	table.store(first, {.distance = 3, .from = 1, .to = 2, .unsolvable = false});
+	const auto found = table.find(first);
+	check(found.has_value() && found->distance == 3 && found->from == 1 && found->to == 2, "stored entry is found");
+	check(!table.find(second).has_value(), "unknown state is not found");
+
+	table.store(second, {.distance = 1, .from = 0, .to = 0, .unsolvable = false});
+	table.store(third, {.distance = 0, .from = 0, .to = 0, .unsolvable = true});
+	check(table.size() == table.capacity(), "a full table evicts instead of growing");
+
+	table.clear();
+	check(table.size() == 0 && !table.find(third).has_value(), "clear forgets every entry");
+}
+
+// an unused cell and an empty battery are both zero, a fact about one board must not leak to the same
+// board with one more empty battery
+auto test_battery_count_is_part_of_the_key() -> void {
+	const auto smaller = parse("11222211").pack();
+	const auto larger = parse("112222110000").pack();
+	check(!(smaller.canonical() == larger.canonical()), "canonical keys differ by battery count");
+	check(!(smaller.color_canonical() == larger.color_canonical()), "color keys differ by battery count");
+
+	for(const auto mode: strategies) {
+		energy::transposition_table::session().clear();
+		check(parse("11222211").solve(mode).empty(), "board without a free battery has no solution");
+		check(parse("112222110000").solve(mode).size() == 3, "same board with a free battery is still solved");
+	}
+}
+
+} // namespace
+
+auto main() -> int {
+	test_store_and_find();
+	test_battery_count_is_part_of_the_key();
+	return energy::test::result();
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+// Parallel breadth-first scaling from one thread up to every hardware thread, over the classic
+// levels with at least min_batteries batteries. Run it from the repository root.
+
+#include <pxe/result.hpp>
+
+#include "../../src/energy/data/parallel.hpp"
+#include "../../src/energy/data/puzzle.hpp"
+#include "../../src/energy/data/solver.hpp"
+#include "../../src/energy/data/transposition_table.hpp"
+#include "../../src/energy/level_manager.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr auto min_batteries = 10;
+
+auto load_hard_levels() -> pxe::result<std::vector<energy::puzzle>> {
+	energy::level_manager levels;
+	if(const auto err = levels.load_levels().unwrap(); err) {
+		return pxe::error("failed to load levels", *err);
+	}
+	std::vector<energy::puzzle> result;
+	for(size_t level = 1; level <= levels.get_total_levels(); ++level) {
+		levels.set_current_level(level);
+		std::string level_str;
+		if(const auto err = levels.get_current_level_string().unwrap(level_str); err) {
+			return pxe::error("failed to get level string", *err);
+		}
+		energy::puzzle parsed;
+		if(const auto err = energy::puzzle::from_string(level_str).unwrap(parsed); err) {
+			return pxe::error("failed to parse level", *err);
+		}
+		if(parsed.size() >= min_batteries) {
+			result.push_back(parsed);
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+auto main() -> int {
+	std::vector<energy::puzzle> puzzles;
+	if(const auto err = load_hard_levels().unwrap(puzzles); err) {
+		std::cerr << "failed to load classic levels\n";
+		return EXIT_FAILURE;
+	}
+
+	// every thread count must solve from scratch
+	energy::transposition_table::session().set_enabled(false);
+
+	std::cout << "threads,puzzles,moves,seconds,speedup\n";
+	auto baseline = 0.0;
+	auto baseline_moves = size_t{0};
+	// doubling from one thread, always ending on every hardware thread even when that is not a power of two
+	std::vector<size_t> steps;
+	for(size_t threads = 1; threads < energy::hardware_threads(); threads *= 2) {
+		steps.push_back(threads);
+	}
+	steps.push_back(energy::hardware_threads());
+	for(const auto threads: steps) {
+		auto moves = size_t{0};
+		const auto start = std::chrono::steady_clock::now();
+		for(const auto &current: puzzles) {
+			moves += energy::solver::parallel_breadth_first(current.pack(), threads).size();
+		}
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if(threads == 1) {
+			baseline = seconds;
+			baseline_moves = moves;
+		}
+		std::cout << std::format(
+			"{},{},{},{:.3f},{:.2f}\n", threads, puzzles.size(), moves, seconds, baseline / seconds);
+		if(moves != baseline_moves) {
+			std::cerr << "parallel solver returned a different total move count\n";
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
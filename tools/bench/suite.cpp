@@ -0,0 +1,317 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+// Solver and generator benchmark suite, prints one CSV row per measurement: every classic level with
+// every strategy, as is, with color symmetry and without move pruning, cosmic generation for every
+// (energies, empty) pair, random and scrambled, and micro benchmarks of move generation and hashing. Run
+// it from the repository root, the optional argument is how many cosmic puzzles to generate per pair.
+
+#include <pxe/result.hpp>
+
+#include "../../src/energy/data/packed_puzzle.hpp"
+#include "../../src/energy/data/puzzle.hpp"
+#include "../../src/energy/data/rng.hpp"
+#include "../../src/energy/data/solver.hpp"
+#include "../../src/energy/data/transposition_table.hpp"
+#include "../../src/energy/level_manager.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <new>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/resource.h>)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> allocated_bytes{0};
+
+constexpr auto default_cosmic_puzzles = 20;
+constexpr auto micro_repeats = 2000;
+constexpr auto scramble_depth = 64;
+
+constexpr std::array<std::pair<energy::puzzle::strategy, std::string_view>, 6> strategies{{
+	{energy::puzzle::strategy::breadth_first, "breadth_first"},
+	{energy::puzzle::strategy::depth_first, "depth_first"},
+	{energy::puzzle::strategy::a_star, "a_star"},
+	{energy::puzzle::strategy::ida_star, "ida_star"},
+	{energy::puzzle::strategy::parallel_breadth_first, "parallel_breadth_first"},
+	{energy::puzzle::strategy::bidirectional, "bidirectional"},
+}};
+
+// kilobytes on Linux, zero where getrusage is not available
+auto peak_rss() -> long {
+#if __has_include(<sys/resource.h>)
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+#else
+	return 0;
+#endif
+}
+
+// runs work, which returns a result checksum, and prints its row; operations is what nodes/s is
+// computed from, the expanded solver nodes when it is zero
+template<typename Work>
+auto measure(const std::string_view section,
+			 const std::string_view name,
+			 const std::size_t items,
+			 const std::uint64_t operations,
+			 Work &&work) -> void {
+	energy::solver::reset_expanded_nodes();
+	const auto allocations_before = allocations.load();
+	const auto bytes_before = allocated_bytes.load();
+	const auto start = std::chrono::steady_clock::now();
+	const auto result = work();
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const auto nodes = operations != 0 ? operations : energy::solver::expanded_nodes();
+	std::cout << std::format("{},{},{},{},{},{:.6f},{:.0f},{},{},{}\n",
+							 section,
+							 name,
+							 items,
+							 result,
+							 nodes,
+							 seconds,
+							 seconds > 0.0 ? static_cast<double>(nodes) / seconds : 0.0,
+							 allocations.load() - allocations_before,
+							 allocated_bytes.load() - bytes_before,
+							 peak_rss());
+}
+
+auto load_classic_levels() -> pxe::result<std::vector<energy::puzzle>> {
+	energy::level_manager levels;
+	if(const auto err = levels.load_levels().unwrap(); err) {
+		return pxe::error("failed to load levels", *err);
+	}
+	std::vector<energy::puzzle> result;
+	for(size_t level = 1; level <= levels.get_total_levels(); ++level) {
+		levels.set_current_level(level);
+		std::string level_str;
+		if(const auto err = levels.get_current_level_string().unwrap(level_str); err) {
+			return pxe::error("failed to get level string", *err);
+		}
+		energy::puzzle parsed;
+		if(const auto err = energy::puzzle::from_string(level_str).unwrap(parsed); err) {
+			return pxe::error("failed to parse level", *err);
+		}
+		result.push_back(parsed);
+	}
+	return result;
+}
+
+auto load_cosmic_settings() -> pxe::result<std::set<std::pair<size_t, size_t>>> {
+	energy::level_manager levels;
+	if(const auto err = levels.load_levels().unwrap(); err) {
+		return pxe::error("failed to load levels", *err);
+	}
+	std::set<std::pair<size_t, size_t>> result;
+	for(const auto level: {energy::level_manager::difficulty::normal,
+						   energy::level_manager::difficulty::hard,
+						   energy::level_manager::difficulty::burger_daddy}) {
+		for(const auto &range: levels.get_cosmic_ranges(level)) {
+			result.emplace(range.energies, range.empty);
+		}
+	}
+	return result;
+}
+
+// section tells the solver settings apart, every setting solves the same levels with every strategy
+auto bench_solve(const std::vector<energy::puzzle> &puzzles, const std::string_view section) -> void {
+	for(const auto &[mode, name]: strategies) {
+		measure(section, name, puzzles.size(), 0, [&]() -> std::size_t {
+			std::size_t moves = 0;
+			for(const auto &current: puzzles) {
+				moves += current.solve(mode).size();
+			}
+			return moves;
+		});
+	}
+}
+
+auto bench_generate(const std::set<std::pair<size_t, size_t>> &settings, const std::size_t count) -> void {
+	for(const auto &[energies, empty]: settings) {
+		energy::rng engine{(energies * 100) + empty};
+		energy::level_manager::reset_filter_stats();
+		measure("generate", std::format("{}_energies_{}_empty", energies, empty), count, 0, [&]() -> std::size_t {
+			std::set<std::string> distinct;
+			for(std::size_t i = 0; i < count; ++i) {
+				distinct.insert(energy::level_manager::generate_cosmic_level_string(energies, empty, engine));
+			}
+			return distinct.size();
+		});
+		// kept off the CSV: how many candidates each tier of the solvability filter settled
+		const auto stats = energy::level_manager::get_filter_stats();
+		std::cerr << std::format("{} energies {} empty: {} candidates, {} without moves, "
+								 "{}/{} probe rejected/accepted, {}/{} search rejected/accepted\n",
+								 energies,
+								 empty,
+								 stats.candidates,
+								 stats.structural_rejects,
+								 stats.probe_rejects,
+								 stats.probe_accepts,
+								 stats.search_rejects,
+								 stats.search_accepts);
+	}
+}
+
+auto bench_scramble(const std::set<std::pair<size_t, size_t>> &settings, const std::size_t count) -> void {
+	for(const auto &[energies, empty]: settings) {
+		energy::rng engine{(energies * 100) + empty};
+		measure("scramble", std::format("{}_energies_{}_empty", energies, empty), count, 0, [&]() -> std::size_t {
+			std::set<std::string> distinct;
+			for(std::size_t i = 0; i < count; ++i) {
+				distinct.insert(
+					energy::level_manager::scramble_cosmic_level_string(energies, empty, scramble_depth, engine));
+			}
+			return distinct.size();
+		});
+	}
+}
+
+auto bench_micro(const std::vector<energy::puzzle> &puzzles) -> void {
+	std::vector<energy::packed_puzzle> packed;
+	std::uint64_t pairs = 0;
+	for(const auto &current: puzzles) {
+		packed.push_back(current.pack());
+		pairs += current.size() * current.size();
+	}
+	const auto repeats = static_cast<std::uint64_t>(micro_repeats);
+
+	measure("micro", "battery_can_get_from", puzzles.size(), pairs * repeats, [&]() -> std::size_t {
+		std::size_t legal = 0;
+		for(std::uint64_t round = 0; round < repeats; ++round) {
+			for(const auto &current: puzzles) {
+				for(size_t from = 0; from < current.size(); ++from) {
+					for(size_t to = 0; to < current.size(); ++to) {
+						legal += static_cast<std::size_t>(from != to && current.at(to).can_get_from(current.at(from)));
+					}
+				}
+			}
+		}
+		return legal;
+	});
+
+	measure("micro", "packed_can_transfer", packed.size(), pairs * repeats, [&]() -> std::size_t {
+		std::size_t legal = 0;
+		for(std::uint64_t round = 0; round < repeats; ++round) {
+			for(const auto &current: packed) {
+				for(size_t from = 0; from < current.size(); ++from) {
+					for(size_t to = 0; to < current.size(); ++to) {
+						legal += static_cast<std::size_t>(from != to && current.can_transfer(from, to));
+					}
+				}
+			}
+		}
+		return legal;
+	});
+
+	measure("micro", "packed_legal_moves", packed.size(), pairs * repeats, [&]() -> std::size_t {
+		std::size_t legal = 0;
+		for(std::uint64_t round = 0; round < repeats; ++round) {
+			for(const auto &current: packed) {
+				for(const auto targets: current.legal_moves()) {
+					legal += static_cast<std::size_t>(std::popcount(targets));
+				}
+			}
+		}
+		return legal;
+	});
+
+	measure("micro", "puzzle_id", puzzles.size(), puzzles.size() * repeats, [&]() -> std::size_t {
+		std::size_t length = 0;
+		for(std::uint64_t round = 0; round < repeats; ++round) {
+			for(const auto &current: puzzles) {
+				length += current.id().size();
+			}
+		}
+		return length;
+	});
+
+	measure("micro", "packed_canonical", packed.size(), packed.size() * repeats, [&]() -> std::size_t {
+		std::uint64_t combined = 0;
+		for(std::uint64_t round = 0; round < repeats; ++round) {
+			for(const auto &current: packed) {
+				combined ^= current.canonical().bits.at(0) + round;
+			}
+		}
+		return static_cast<std::size_t>(combined);
+	});
+
+	measure("micro", "puzzle_pack", puzzles.size(), puzzles.size() * repeats, [&]() -> std::size_t {
+		std::uint64_t combined = 0;
+		for(std::uint64_t round = 0; round < repeats; ++round) {
+			for(const auto &current: puzzles) {
+				combined ^= current.pack().hash() + round;
+			}
+		}
+		return static_cast<std::size_t>(combined);
+	});
+}
+
+} // namespace
+
+// counted global allocations, the aligned forms are left to the standard library
+auto operator new(const std::size_t size) -> void * {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	if(auto *memory = std::malloc(size == 0 ? 1 : size); memory != nullptr) { // NOLINT(*-no-malloc,*-owning-memory)
+		return memory;
+	}
+	std::abort();
+}
+
+auto operator delete(void *memory) noexcept -> void {
+	std::free(memory); // NOLINT(*-no-malloc,*-owning-memory)
+}
+
+auto operator delete(void *memory, std::size_t /*size*/) noexcept -> void {
+	std::free(memory); // NOLINT(*-no-malloc,*-owning-memory)
+}
+
+auto main(const int argc, char *argv[]) -> int {
+	const std::vector<std::string> args(argv, argv + argc); // NOLINT(*-pointer-arithmetic)
+	const auto cosmic_puzzles = args.size() > 1 ? std::stoul(args.at(1)) : default_cosmic_puzzles;
+
+	std::vector<energy::puzzle> puzzles;
+	if(const auto err = load_classic_levels().unwrap(puzzles); err) {
+		std::cerr << "failed to load classic levels\n";
+		return EXIT_FAILURE;
+	}
+	std::set<std::pair<size_t, size_t>> settings;
+	if(const auto err = load_cosmic_settings().unwrap(settings); err) {
+		std::cerr << "failed to load cosmic levels\n";
+		return EXIT_FAILURE;
+	}
+
+	// every measurement must do its own work
+	energy::transposition_table::session().set_enabled(false);
+
+	std::cout << "section,name,items,result,nodes,seconds,nodes_per_second,allocations,bytes,peak_rss_kb\n";
+	bench_solve(puzzles, "solve");
+	// color-canonical state keys, the drop in nodes is how much of the space relabeling merges
+	energy::solver::set_color_symmetry(true);
+	bench_solve(puzzles, "solve_color_symmetry");
+	energy::solver::set_color_symmetry(false);
+	// every successor searched, the rise in nodes is what the symmetry and dominance pruning saves
+	energy::solver::set_move_pruning(false);
+	bench_solve(puzzles, "solve_unpruned");
+	energy::solver::set_move_pruning(true);
+	bench_generate(settings, cosmic_puzzles);
+	bench_scramble(settings, cosmic_puzzles);
+	bench_micro(puzzles);
+	return EXIT_SUCCESS;
+}
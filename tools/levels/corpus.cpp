@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+// Builds the precomputed cosmic corpus: for every (energies, empty) shape used in cosmic.json it
+// generates puzzles from disjoint seeds across threads, keeps the first occurrence of each canonical
+// state and records its optimal move count. The same seed always writes the same file.
+//
+//   energy-swap-corpus [output file] [puzzles per shape] [seed] [threads]
+
+#include <pxe/result.hpp>
+
+#include "../../src/energy/data/cosmic_corpus.hpp"
+#include "../../src/energy/data/packed_puzzle.hpp"
+#include "../../src/energy/data/parallel.hpp"
+#include "../../src/energy/data/puzzle.hpp"
+#include "../../src/energy/data/rng.hpp"
+#include "../../src/energy/data/solver.hpp"
+#include "../../src/energy/level_manager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr auto default_corpus_path = "resources/levels/cosmic.bin";
+constexpr auto default_puzzles_per_shape = 256;
+constexpr auto default_seed = 0x0C05'41C0'0000'0001ULL;
+
+auto load_shapes() -> pxe::result<std::set<std::pair<size_t, size_t>>> {
+	energy::level_manager levels;
+	if(const auto err = levels.load_levels().unwrap(); err) {
+		return pxe::error("failed to load levels", *err);
+	}
+	std::set<std::pair<size_t, size_t>> result;
+	for(const auto level: {energy::level_manager::difficulty::normal,
+						   energy::level_manager::difficulty::hard,
+						   energy::level_manager::difficulty::burger_daddy}) {
+		for(const auto &range: levels.get_cosmic_ranges(level)) {
+			result.emplace(range.energies, range.empty);
+		}
+	}
+	return result;
+}
+
+// every candidate has its own stream, so which thread builds it never changes the result
+auto build_shape(const size_t energies,
+				 const size_t empty,
+				 const size_t count,
+				 const std::uint64_t seed,
+				 const size_t threads) -> energy::cosmic_corpus::shape_levels {
+	const auto shape_seed = energy::rng::derive(seed, (energies << 8U) | empty);
+	std::vector<energy::cosmic_corpus::level> candidates(count);
+	energy::parallel_for(count, threads, [&](std::size_t, const std::size_t begin, const std::size_t end) -> void {
+		for(auto i = begin; i < end; ++i) {
+			energy::rng engine{energy::rng::derive(shape_seed, i)};
+			auto &candidate = candidates.at(i);
+			candidate.puzzle = energy::level_manager::generate_cosmic_level_string(energies, empty, engine);
+			energy::puzzle parsed;
+			if(const auto err = energy::puzzle::from_string(candidate.puzzle).unwrap(parsed); !err) {
+				candidate.moves = energy::solver::a_star(parsed.pack()).size();
+			}
+		}
+	});
+
+	energy::cosmic_corpus::shape_levels result{.energies = energies, .empty = empty, .levels = {}};
+	std::unordered_set<energy::packed_puzzle::key, energy::packed_puzzle::key_hash> seen;
+	for(auto &candidate: candidates) {
+		// already solved boards have nothing to play
+		energy::puzzle parsed;
+		if(const auto err = energy::puzzle::from_string(candidate.puzzle).unwrap(parsed); err || parsed.is_solved()) {
+			continue;
+		}
+		if(seen.insert(parsed.pack().canonical()).second) {
+			result.levels.push_back(std::move(candidate));
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+auto main(const int argc, char *argv[]) -> int {
+	const std::vector<std::string> args(argv, argv + argc); // NOLINT(*-pointer-arithmetic)
+	const auto path = args.size() > 1 ? args.at(1) : std::string{default_corpus_path};
+	const auto count = args.size() > 2 ? std::stoul(args.at(2)) : default_puzzles_per_shape;
+	const auto seed = args.size() > 3 ? std::stoull(args.at(3), nullptr, 0) : default_seed;
+	const auto threads = std::max<size_t>(1, args.size() > 4 ? std::stoul(args.at(4)) : energy::hardware_threads());
+
+	std::set<std::pair<size_t, size_t>> shapes;
+	if(const auto err = load_shapes().unwrap(shapes); err) {
+		std::cerr << "failed to load cosmic levels\n";
+		return EXIT_FAILURE;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<energy::cosmic_corpus::shape_levels> corpus;
+	for(const auto &[energies, empty]: shapes) {
+		corpus.push_back(build_shape(energies, empty, count, seed, threads));
+		const auto &built = corpus.back();
+		if(built.levels.empty()) {
+			std::cerr << std::format("{} energies {} empty: no puzzles\n", energies, empty);
+			continue;
+		}
+		const auto [shortest, longest] = std::ranges::minmax(
+			built.levels, {}, [](const energy::cosmic_corpus::level &level) -> size_t { return level.moves; });
+		std::cerr << std::format("{} energies {} empty: {} puzzles, {} to {} moves\n",
+								 energies,
+								 empty,
+								 built.levels.size(),
+								 shortest.moves,
+								 longest.moves);
+	}
+
+	if(const auto err = energy::cosmic_corpus::write(path, corpus).unwrap(); err) {
+		std::cerr << std::format("failed to write corpus to {}\n", path);
+		return EXIT_FAILURE;
+	}
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cerr << std::format("wrote {} shapes to {} in {:.3f} seconds\n", corpus.size(), path, seconds);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+// Classic level pack generator. Generates solvable puzzles for every board from 3 to 12 batteries from
+// disjoint seeds across threads, solves them optimally, drops repeats (same state up to battery order and
+// color relabeling) and writes the requested number of levels in the classic.json format, from easiest to
+// hardest: by optimal moves, then battery count, then the average number of legal moves along the
+// solution. The same seed always writes the same file.
+//
+//   energy-swap-curriculum [output file] [levels] [candidates per board] [seed] [threads]
+
+#include <pxe/result.hpp>
+
+#include "../../src/energy/data/battery.hpp"
+#include "../../src/energy/data/packed_puzzle.hpp"
+#include "../../src/energy/data/parallel.hpp"
+#include "../../src/energy/data/puzzle.hpp"
+#include "../../src/energy/data/rng.hpp"
+#include "../../src/energy/data/solver.hpp"
+#include "../../src/energy/level_manager.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr auto default_output_path = "curriculum.json";
+constexpr auto default_levels = 1000;
+constexpr auto default_candidates_per_board = 256;
+constexpr auto default_seed = 0xC1A5'51C0'0000'0001ULL;
+constexpr size_t min_energies = 2;
+constexpr size_t max_empty = 2;
+
+struct candidate {
+	std::string puzzle;
+	size_t moves{0};
+	size_t batteries{0};
+	// average legal moves over the states of the optimal solution, more choices to weigh is harder
+	double branching{0.0};
+	bool solvable{false};
+};
+
+// every board the classic pack can show, one or two empty batteries with as many colors as fit
+auto boards() -> std::vector<std::pair<size_t, size_t>> {
+	std::vector<std::pair<size_t, size_t>> result;
+	constexpr auto max_energies = static_cast<size_t>(energy::battery::max_energy_types);
+	for(auto energies = min_energies; energies <= max_energies; ++energies) {
+		for(size_t empty = 1; empty <= max_empty && energies + empty <= energy::packed_puzzle::max_batteries; ++empty) {
+			result.emplace_back(energies, empty);
+		}
+	}
+	return result;
+}
+
+auto evaluate(const size_t energies, const size_t empty, energy::rng &engine) -> candidate {
+	candidate result{.puzzle = energy::level_manager::generate_cosmic_level_string(energies, empty, engine)};
+	energy::puzzle parsed;
+	if(const auto err = energy::puzzle::from_string(result.puzzle).unwrap(parsed); err || parsed.is_solved()) {
+		return result;
+	}
+	auto state = parsed.pack();
+	const auto solution = energy::solver::a_star(state);
+	if(solution.empty()) {
+		return result;
+	}
+	auto choices = state.legal_move_count();
+	for(const auto &[from, to]: solution) {
+		state.transfer(from, to);
+		choices += state.legal_move_count();
+	}
+	result.moves = solution.size();
+	result.batteries = parsed.size();
+	// the solved state has no moves left, so it is not counted
+	result.branching = static_cast<double>(choices) / static_cast<double>(solution.size());
+	result.solvable = true;
+	return result;
+}
+
+// picks count levels spread evenly over the sorted candidates, so the curve keeps its full range
+auto select(const std::vector<candidate> &sorted, const size_t count) -> std::vector<candidate> {
+	if(sorted.size() <= count) {
+		return sorted;
+	}
+	std::vector<candidate> result;
+	result.reserve(count);
+	for(size_t i = 0; i < count; ++i) {
+		result.push_back(sorted.at(count > 1 ? i * (sorted.size() - 1) / (count - 1) : 0));
+	}
+	return result;
+}
+
+auto write_levels(const std::string &path, const std::vector<candidate> &levels) -> pxe::result<> {
+	std::ofstream file(path, std::ios::trunc);
+	if(!file.is_open()) {
+		return pxe::error(std::format("failed to create levels file: {}", path));
+	}
+	file << "[\n";
+	for(size_t i = 0; i < levels.size(); ++i) {
+		const auto &level = levels.at(i);
+		file << std::format("\t{{\n\t\t\"puzzle\": \"{}\",\n\t\t\"moves\": {},\n\t\t\"num_batteries\": {}\n\t}}{}\n",
+							level.puzzle,
+							level.moves,
+							level.batteries,
+							i + 1 < levels.size() ? "," : "");
+	}
+	file << "]\n";
+	if(!file) {
+		return pxe::error(std::format("failed to write levels file: {}", path));
+	}
+	return true;
+}
+
+} // namespace
+
+auto main(const int argc, char *argv[]) -> int {
+	const std::vector<std::string> args(argv, argv + argc); // NOLINT(*-pointer-arithmetic)
+	const auto path = args.size() > 1 ? args.at(1) : std::string{default_output_path};
+	const auto levels = args.size() > 2 ? std::stoul(args.at(2)) : default_levels;
+	const auto per_board = args.size() > 3 ? std::stoul(args.at(3)) : default_candidates_per_board;
+	const auto seed = args.size() > 4 ? std::stoull(args.at(4), nullptr, 0) : default_seed;
+	const auto threads = std::max<size_t>(1, args.size() > 5 ? std::stoul(args.at(5)) : energy::hardware_threads());
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto shapes = boards();
+	std::vector<candidate> candidates(shapes.size() * per_board);
+
+	// every candidate has its own stream, so which thread builds it never changes the result; workers pull
+	// the next one as they go since the big boards take far longer to solve
+	std::atomic<size_t> next{0};
+	energy::parallel_for(threads, threads, [&](std::size_t, std::size_t, std::size_t) -> void {
+		for(auto i = next.fetch_add(1); i < candidates.size(); i = next.fetch_add(1)) {
+			const auto &[energies, empty] = shapes.at(i / per_board);
+			energy::rng engine{energy::rng::derive(energy::rng::derive(seed, (energies << 8U) | empty), i % per_board)};
+			candidates.at(i) = evaluate(energies, empty, engine);
+		}
+	});
+
+	std::vector<candidate> unique;
+	std::unordered_set<energy::packed_puzzle::key, energy::packed_puzzle::key_hash> seen;
+	for(auto &current: candidates) {
+		energy::puzzle parsed;
+		if(const auto err = energy::puzzle::from_string(current.puzzle).unwrap(parsed); err || !current.solvable) {
+			continue;
+		}
+		if(seen.insert(parsed.pack().color_canonical()).second) {
+			unique.push_back(std::move(current));
+		}
+	}
+	std::ranges::sort(unique, [](const candidate &lhs, const candidate &rhs) -> bool {
+		return std::tie(lhs.moves, lhs.batteries, lhs.branching, lhs.puzzle)
+			   < std::tie(rhs.moves, rhs.batteries, rhs.branching, rhs.puzzle);
+	});
+
+	const auto curriculum = select(unique, levels);
+	if(const auto err = write_levels(path, curriculum).unwrap(); err) {
+		std::cerr << std::format("failed to write levels to {}\n", path);
+		return EXIT_FAILURE;
+	}
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cerr << std::format("{} candidates, {} distinct, wrote {} levels from {} to {} moves "
+							 "to {} in {:.3f} seconds\n",
+							 candidates.size(),
+							 unique.size(),
+							 curriculum.size(),
+							 curriculum.empty() ? 0 : curriculum.front().moves,
+							 curriculum.empty() ? 0 : curriculum.back().moves,
+							 path,
+							 seconds);
+	return EXIT_SUCCESS;
+}
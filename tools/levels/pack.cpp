@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+// Converts the authored json levels, classic.json and cosmic.json, into the binary level pack the game
+// loads at startup. Run it from the repository root after editing either file.
+//
+//   energy-swap-pack [output file]
+
+#include "../../src/energy/level_manager.hpp"
+
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr auto default_pack_path = "resources/levels/levels.bin";
+
+} // namespace
+
+auto main(const int argc, char *argv[]) -> int {
+	const std::vector<std::string> args(argv, argv + argc); // NOLINT(*-pointer-arithmetic)
+	const auto path = args.size() > 1 ? args.at(1) : std::string{default_pack_path};
+
+	energy::level_manager levels;
+	if(const auto err = levels.load_json_levels().unwrap(); err) {
+		std::cerr << "failed to load json levels\n";
+		return EXIT_FAILURE;
+	}
+	if(const auto err = levels.write_level_pack(path).unwrap(); err) {
+		std::cerr << std::format("failed to write level pack to {}\n", path);
+		return EXIT_FAILURE;
+	}
+	std::cerr << std::format("wrote {} levels to {}\n", levels.get_total_levels(), path);
+	return EXIT_SUCCESS;
+}
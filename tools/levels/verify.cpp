@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2026 Juan Medina
+// SPDX-License-Identifier: MIT
+
+// Headless level pack checker. Reads a classic.json style file, or a text file with one puzzle string
+// per line, solves every entry optimally across threads and prints one CSV row per entry with the
+// recorded and the optimal move count. Mismatches, unsolvable entries, unparseable strings and
+// duplicates of an earlier entry (same canonical state) are flagged and make it exit with failure.
+//
+//   energy-swap-verify [levels file] [threads]
+
+#include <pxe/result.hpp>
+
+#include "../../src/energy/data/packed_puzzle.hpp"
+#include "../../src/energy/data/parallel.hpp"
+#include "../../src/energy/data/puzzle.hpp"
+#include "../../src/energy/data/solver.hpp"
+#include "../../src/energy/level_manager.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr auto default_levels_path = "resources/levels/classic.json";
+
+enum class status : std::uint8_t {
+	ok,
+	mismatch,
+	unsolvable,
+	duplicate,
+	invalid,
+};
+
+auto status_name(const status value) -> std::string_view {
+	switch(value) {
+	case status::ok:
+		return "ok";
+	case status::mismatch:
+		return "mismatch";
+	case status::unsolvable:
+		return "unsolvable";
+	case status::duplicate:
+		return "duplicate";
+	case status::invalid:
+		return "invalid";
+	}
+	return "unknown";
+}
+
+struct report {
+	std::optional<energy::puzzle> parsed;
+	std::optional<size_t> optimal;
+	std::optional<size_t> duplicate_of;
+	status result{status::ok};
+};
+
+auto read_levels(const std::string &path) -> pxe::result<std::vector<energy::level_manager::classic_level>> {
+	if(path.ends_with(".json")) {
+		return energy::level_manager::read_classic_levels(path);
+	}
+	std::ifstream file(path);
+	if(!file.is_open()) {
+		return pxe::error(std::format("failed to open puzzle list: {}", path));
+	}
+	std::vector<energy::level_manager::classic_level> levels;
+	std::string line;
+	while(std::getline(file, line)) {
+		if(!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		if(line.empty() || line.front() == '#') {
+			continue;
+		}
+		levels.push_back({.puzzle = line, .moves = std::nullopt});
+	}
+	return levels;
+}
+
+} // namespace
+
+auto main(const int argc, char *argv[]) -> int {
+	const std::vector<std::string> args(argv, argv + argc); // NOLINT(*-pointer-arithmetic)
+	const auto path = args.size() > 1 ? args.at(1) : std::string{default_levels_path};
+	const auto threads = std::max<size_t>(1, args.size() > 2 ? std::stoul(args.at(2)) : energy::hardware_threads());
+
+	std::vector<energy::level_manager::classic_level> levels;
+	if(const auto err = read_levels(path).unwrap(levels); err) {
+		std::cerr << std::format("failed to read levels from {}\n", path);
+		return EXIT_FAILURE;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<report> reports(levels.size());
+	std::unordered_map<energy::packed_puzzle::key, size_t, energy::packed_puzzle::key_hash> first_seen;
+	for(size_t i = 0; i < levels.size(); ++i) {
+		auto &current = reports.at(i);
+		energy::puzzle parsed;
+		if(const auto err = energy::puzzle::from_string(levels.at(i).puzzle).unwrap(parsed); err) {
+			current.result = status::invalid;
+			continue;
+		}
+		current.parsed = parsed;
+		if(const auto [it, inserted] = first_seen.try_emplace(parsed.pack().canonical(), i); !inserted) {
+			current.duplicate_of = it->second;
+		}
+	}
+
+	// workers pull the next entry as they go, hard levels tend to sit together at the end of a pack
+	std::atomic<size_t> next{0};
+	energy::parallel_for(threads, threads, [&](std::size_t, std::size_t, std::size_t) -> void {
+		for(auto i = next.fetch_add(1); i < reports.size(); i = next.fetch_add(1)) {
+			auto &current = reports.at(i);
+			if(!current.parsed.has_value()) {
+				continue;
+			}
+			const auto &parsed = *current.parsed;
+			if(const auto solution = energy::solver::a_star(parsed.pack()); !solution.empty() || parsed.is_solved()) {
+				current.optimal = solution.size();
+			}
+		}
+	});
+
+	auto problems = size_t{0};
+	std::cout << "level,puzzle,recorded,optimal,status,duplicate_of\n";
+	for(size_t i = 0; i < reports.size(); ++i) {
+		auto &current = reports.at(i);
+		const auto &recorded = levels.at(i).moves;
+		if(current.result != status::invalid) {
+			if(!current.optimal.has_value()) {
+				current.result = status::unsolvable;
+			} else if(current.duplicate_of.has_value()) {
+				current.result = status::duplicate;
+			} else if(recorded.has_value() && *recorded != *current.optimal) {
+				current.result = status::mismatch;
+			}
+		}
+		problems += current.result == status::ok ? 0 : 1;
+		std::cout << std::format("{},{},{},{},{},{}\n",
+								 i + 1,
+								 levels.at(i).puzzle,
+								 recorded.has_value() ? std::to_string(*recorded) : "",
+								 current.optimal.has_value() ? std::to_string(*current.optimal) : "",
+								 status_name(current.result),
+								 current.duplicate_of.has_value() ? std::to_string(*current.duplicate_of + 1) : "");
+	}
+
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cerr << std::format(
+		"{} levels, {} problems, {} threads, {:.3f} seconds\n", levels.size(), problems, threads, seconds);
+	return problems == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}